@@ -0,0 +1,270 @@
+/**
+ * @file BatchJob.cpp
+ * @brief Реализация методов класса BatchJob.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "BatchJob.h"
+
+/**
+ * @brief Первая строка манифеста; номер версии меняется при изменении формата.
+ */
+static const char* const MANIFEST_HEADER = "# emotion batch manifest v1";
+
+/**
+ * @brief Количество полей строки манифеста (путь - последнее поле).
+ */
+static const size_t MANIFEST_FIELDS = 9;
+
+/**
+ * @brief Получает название состояния.
+ * @param status Состояние.
+ * @return Название состояния.
+ */
+const char* BatchJob::statusName(Status status) {
+    switch (status) {
+        case PENDING: return "pending";
+        case RUNNING: return "running";
+        case DONE: return "done";
+        case FAILED: return "failed";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Разбирает название состояния.
+ * @param name Название состояния.
+ * @return Состояние.
+ */
+static BatchJob::Status parseStatus(const std::string& name) {
+    for (int status = BatchJob::PENDING; status <= BatchJob::FAILED; status++) {
+        if (name == BatchJob::statusName(static_cast<BatchJob::Status>(status))) {
+            return static_cast<BatchJob::Status>(status);
+        }
+    }
+    throw std::invalid_argument("unknown status " + name);
+}
+
+/**
+ * @brief Конструктор манифеста.
+ * @param manifest_path Путь к файлу манифеста.
+ * @param class_count Количество классов в статистике.
+ */
+BatchJob::BatchJob(const std::string& manifest_path, size_t class_count)
+    : manifest_path(manifest_path), class_count(class_count) {}
+
+/**
+ * @brief Загружает манифест.
+ * @return false, если файл существует, но повреждён.
+ */
+bool BatchJob::load() {
+    files.clear();
+    std::ifstream input(manifest_path);
+    if (!input.is_open()) {
+        return !std::filesystem::exists(manifest_path);
+    }
+
+    std::string line;
+    if (!std::getline(input, line) || line != MANIFEST_HEADER) {
+        return false;
+    }
+
+    try {
+        while (std::getline(input, line)) {
+            if (line.empty()) {
+                continue;
+            }
+
+            // Путь - последнее поле и может содержать любые символы, кроме перевода строки
+            std::vector<std::string> fields;
+            size_t start = 0;
+            while (fields.size() + 1 < MANIFEST_FIELDS) {
+                size_t tab = line.find('\t', start);
+                if (tab == std::string::npos) {
+                    return false;
+                }
+                fields.push_back(line.substr(start, tab - start));
+                start = tab + 1;
+            }
+            fields.push_back(line.substr(start));
+
+            Entry entry;
+            entry.status = parseStatus(fields[0]);
+            entry.size = std::stoull(fields[1]);
+            entry.mtime = std::stoll(fields[2]);
+            entry.attempts = std::stoi(fields[3]);
+            entry.position = std::stod(fields[4]);
+            entry.next_record = std::stod(fields[5]);
+            entry.last_class = std::stoi(fields[6]);
+
+            std::istringstream counts(fields[7]);
+            std::string count;
+            while (std::getline(counts, count, ',')) {
+                entry.class_seconds.push_back(std::stoull(count));
+            }
+            if (entry.class_seconds.size() != class_count ||
+                entry.last_class < -1 || entry.last_class >= static_cast<int>(class_count)) {
+                return false;
+            }
+
+            entry.path = fields[8];
+            files.push_back(entry);
+        }
+    } catch (const std::exception&) {
+        files.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Атомарно сохраняет манифест.
+ * Временный файл синхронизируется с диском до переименования, а каталог - после,
+ * поэтому при сбое питания манифест содержит либо старую, либо новую контрольную точку целиком.
+ * @return true, если манифест сохранён.
+ */
+bool BatchJob::save() const {
+    std::string temporary_path = manifest_path + ".tmp";
+    FILE* file = std::fopen(temporary_path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::fprintf(file, "%s\n", MANIFEST_HEADER);
+    for (const Entry& entry : files) {
+        std::string counts;
+        for (size_t i = 0; i < entry.class_seconds.size(); i++) {
+            counts += (i > 0 ? "," : "") + std::to_string(entry.class_seconds[i]);
+        }
+        std::fprintf(file, "%s\t%llu\t%lld\t%d\t%.6f\t%.6f\t%d\t%s\t%s\n", statusName(entry.status),
+                     static_cast<unsigned long long>(entry.size), static_cast<long long>(entry.mtime), entry.attempts,
+                     entry.position, entry.next_record, entry.last_class, counts.c_str(), entry.path.c_str());
+    }
+
+    bool written = std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+    written = std::fclose(file) == 0 && written;
+    if (!written || std::rename(temporary_path.c_str(), manifest_path.c_str()) != 0) {
+        std::remove(temporary_path.c_str());
+        return false;
+    }
+
+    // Синхронизация каталога закрепляет само переименование
+    std::string directory = std::filesystem::path(manifest_path).parent_path().string();
+    int directory_fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (directory_fd >= 0) {
+        fsync(directory_fd);
+        ::close(directory_fd);
+    }
+    return true;
+}
+
+/**
+ * @brief Получает отпечаток файла.
+ * @param path Путь к файлу.
+ * @param size Размер файла.
+ * @param mtime Время изменения файла во внутренних единицах файловой системы.
+ * @return true, если файл существует.
+ */
+bool BatchJob::fingerprint(const std::string& path, uint64_t& size, int64_t& mtime) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        size = 0;
+        mtime = 0;
+        return false;
+    }
+    auto write_time = std::filesystem::last_write_time(path, error);
+    mtime = error ? 0 : static_cast<int64_t>(write_time.time_since_epoch().count());
+    return true;
+}
+
+/**
+ * @brief Добавляет файлы в манифест.
+ * @param paths Пути к видеофайлам.
+ * @return Количество новых и сброшенных файлов.
+ */
+size_t BatchJob::addFiles(const std::vector<std::string>& paths) {
+    // Индекс по пути строится один раз: поиск каждого файла в списке делал бы добавление
+    // архива из n файлов квадратичным
+    std::unordered_map<std::string, size_t> index;
+    index.reserve(files.size() + paths.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        index.emplace(files[i].path, i);
+    }
+
+    size_t added = 0;
+    for (const std::string& path : paths) {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        fingerprint(path, size, mtime);
+
+        Entry* existing = nullptr;
+        auto found = index.find(path);
+        if (found == index.end()) {
+            index.emplace(path, files.size());
+            files.push_back(Entry());
+            existing = &files.back();
+            existing->path = path;
+        } else {
+            existing = &files[found->second];
+            if (existing->size == size && existing->mtime == mtime) {
+                continue;
+            }
+        }
+
+        // Новый или изменившийся файл обрабатывается с начала
+        existing->status = PENDING;
+        existing->size = size;
+        existing->mtime = mtime;
+        existing->attempts = 0;
+        resetProgress(*existing);
+        added++;
+    }
+    return added;
+}
+
+/**
+ * @brief Проверяет, нужно ли обрабатывать файл.
+ * @param entry Файл манифеста.
+ * @param max_attempts Наибольшее количество попыток для файлов с ошибкой.
+ * @return true, если файл не обработан и попытки не исчерпаны.
+ */
+bool BatchJob::needsWork(const Entry& entry, int max_attempts) {
+    // Файл, прерванный аварийным завершением, остаётся RUNNING и тоже расходует попытки
+    return entry.status != DONE && entry.attempts < max_attempts;
+}
+
+/**
+ * @brief Сбрасывает позицию и статистику файла.
+ * @param entry Файл манифеста.
+ */
+void BatchJob::resetProgress(Entry& entry) const {
+    entry.position = 0.0;
+    entry.next_record = 0.0;
+    entry.last_class = -1;
+    entry.class_seconds.assign(class_count, 0);
+}
+
+/**
+ * @brief Получает файлы манифеста.
+ * @return Файлы в порядке добавления.
+ */
+std::vector<BatchJob::Entry>& BatchJob::entries() {
+    return files;
+}
+
+/**
+ * @brief Получает путь к манифесту.
+ * @return Путь к файлу манифеста.
+ */
+const std::string& BatchJob::path() const {
+    return manifest_path;
+}
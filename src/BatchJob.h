@@ -0,0 +1,125 @@
+/**
+ * @file BatchJob.h
+ * @brief Объявление класса BatchJob.
+ */
+
+#ifndef BATCHJOB_H
+#define BATCHJOB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class BatchJob
+ * @brief Манифест пакетной обработки видеофайлов с контрольными точками.
+ * Для каждого файла манифест хранит состояние, отпечаток файла (размер и время изменения),
+ * позицию, до которой файл обработан, и частичную статистику по классам. Манифест сохраняется
+ * атомарно (запись во временный файл и переименование), поэтому после аварийного завершения
+ * на диске всегда остаётся последняя целая контрольная точка, с которой обработка продолжается.
+ *
+ * Формат - текст, одна строка на файл, поля разделены табуляцией:
+ * состояние, размер, время изменения, попытки, позиция, следующая секунда статистики,
+ * последний класс, секунды по классам через запятую, путь.
+ */
+class BatchJob {
+
+public:
+    /**
+     * @enum Status
+     * @brief Состояние файла в манифесте.
+     */
+    enum Status {
+        PENDING, ///< Файл ещё не обрабатывался или изменился.
+        RUNNING, ///< Обработка начата; после аварийного завершения продолжается с позиции.
+        DONE, ///< Файл обработан полностью.
+        FAILED ///< Файл не удалось открыть или прочитать.
+    };
+
+    /**
+     * @struct Entry
+     * @brief Файл манифеста и его частичные результаты.
+     */
+    struct Entry {
+        std::string path; ///< Путь к видеофайлу.
+        Status status = PENDING; ///< Состояние обработки.
+        uint64_t size = 0; ///< Размер файла при постановке в манифест.
+        int64_t mtime = 0; ///< Время изменения файла при постановке в манифест.
+        int attempts = 0; ///< Количество начатых попыток обработки.
+        double position = 0.0; ///< Время видео, с которого продолжается обработка, с.
+        double next_record = 0.0; ///< Следующая секунда видео, которая попадёт в статистику.
+        int last_class = -1; ///< Класс последнего обработанного кадра (-1 - лиц не было).
+        std::vector<uint64_t> class_seconds; ///< Количество секунд видео на каждый класс.
+    };
+
+    /**
+     * @brief Получает название состояния.
+     * @param status Состояние.
+     * @return Название состояния, как в манифесте.
+     */
+    static const char* statusName(Status status);
+
+    /**
+     * @brief Конструктор манифеста.
+     * @param manifest_path Путь к файлу манифеста.
+     * @param class_count Количество классов в статистике.
+     */
+    BatchJob(const std::string& manifest_path, size_t class_count);
+
+    /**
+     * @brief Загружает манифест. Отсутствующий файл означает пустой манифест.
+     * @return false, если файл существует, но повреждён.
+     */
+    bool load();
+
+    /**
+     * @brief Атомарно сохраняет манифест: временный файл записывается на диск и заменяет манифест.
+     * @return true, если манифест сохранён.
+     */
+    bool save() const;
+
+    /**
+     * @brief Добавляет файлы в манифест. Новые и изменившиеся с прошлой постановки файлы
+     * (другой размер или время изменения) получают состояние PENDING с пустой статистикой;
+     * остальные сохраняют своё состояние.
+     * @param paths Пути к видеофайлам.
+     * @return Количество новых и сброшенных файлов.
+     */
+    size_t addFiles(const std::vector<std::string>& paths);
+
+    /**
+     * @brief Проверяет, нужно ли обрабатывать файл.
+     * @param entry Файл манифеста.
+     * @param max_attempts Наибольшее количество попыток для файлов с ошибкой или прерванных аварийно.
+     * @return true, если файл не обработан и попытки не исчерпаны.
+     */
+    static bool needsWork(const Entry& entry, int max_attempts);
+
+    /**
+     * @brief Сбрасывает позицию и статистику файла для обработки с начала.
+     * @param entry Файл манифеста.
+     */
+    void resetProgress(Entry& entry) const;
+
+    /**
+     * @brief Получает файлы манифеста.
+     * @return Файлы в порядке добавления.
+     */
+    std::vector<Entry>& entries();
+
+    /**
+     * @brief Получает путь к манифесту.
+     * @return Путь к файлу манифеста.
+     */
+    const std::string& path() const;
+
+private:
+    static bool fingerprint(const std::string& path, uint64_t& size, int64_t& mtime);
+
+    std::string manifest_path; ///< Путь к файлу манифеста.
+    size_t class_count; ///< Количество классов в статистике.
+    std::vector<Entry> files; ///< Файлы манифеста.
+};
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file CaptureSource.cpp
+ * @brief Реализация методов класса CaptureSource.
+ */
+
+#include "CaptureSource.h"
+
+/**
+ * @brief Конструктор открывает камеру.
+ * @param device Индекс камеры.
+ */
+CaptureSource::CaptureSource(int device)
+    : capture(device), from_file(false), start_time(std::chrono::steady_clock::now()) {}
+
+/**
+ * @brief Конструктор открывает видеофайл или поток.
+ * @param filename Путь к файлу или URL потока.
+ */
+CaptureSource::CaptureSource(const std::string& filename)
+    : capture(filename), from_file(true), start_time(std::chrono::steady_clock::now()) {}
+
+/**
+ * @brief Проверяет, открыт ли источник.
+ * @return true, если камера или файл открыты.
+ */
+bool CaptureSource::isOpened() const {
+    return capture.isOpened();
+}
+
+/**
+ * @brief Считывает следующий кадр.
+ * @param frame Кадр; память переиспользуется, если размер и тип не изменились.
+ * @return false, если кадров больше нет.
+ */
+bool CaptureSource::read(cv::Mat& frame) {
+    if (!capture.read(frame)) {
+        return false;
+    }
+
+    // Для камеры время отсчитывается от открытия, для файла - по позиции в нём
+    last_timestamp = from_file
+        ? capture.get(cv::CAP_PROP_POS_MSEC) / 1000.0
+        : std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return true;
+}
+
+/**
+ * @brief Получает время последнего считанного кадра.
+ * @return Время в секундах.
+ */
+double CaptureSource::timestamp() const {
+    return last_timestamp;
+}
+
+/**
+ * @brief Получает свойство захвата.
+ * @param property Идентификатор свойства.
+ * @return Значение свойства.
+ */
+double CaptureSource::get(int property) const {
+    return capture.get(property);
+}
+
+/**
+ * @brief Устанавливает свойство захвата.
+ * @param property Идентификатор свойства.
+ * @param value Значение.
+ * @return true, если свойство установлено.
+ */
+bool CaptureSource::set(int property, double value) {
+    return capture.set(property, value);
+}
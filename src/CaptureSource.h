@@ -0,0 +1,46 @@
+/**
+ * @file CaptureSource.h
+ * @brief Объявление класса CaptureSource.
+ */
+
+#ifndef CAPTURESOURCE_H
+#define CAPTURESOURCE_H
+
+#include <opencv2/videoio.hpp>
+#include <chrono>
+#include <string>
+#include "FrameSource.h"
+
+/**
+ * @class CaptureSource
+ * @brief Источник кадров на основе cv::VideoCapture (камера или видеофайл).
+ */
+class CaptureSource : public FrameSource {
+
+public:
+    /**
+     * @brief Конструктор открывает камеру.
+     * @param device Индекс камеры.
+     */
+    explicit CaptureSource(int device);
+
+    /**
+     * @brief Конструктор открывает видеофайл или поток.
+     * @param filename Путь к файлу или URL потока.
+     */
+    explicit CaptureSource(const std::string& filename);
+
+    bool isOpened() const override;
+    bool read(cv::Mat& frame) override;
+    double timestamp() const override;
+    double get(int property) const override;
+    bool set(int property, double value) override;
+
+private:
+    cv::VideoCapture capture; ///< Объект захвата видео.
+    bool from_file; ///< Источник - файл: время кадра берётся из позиции в файле.
+    std::chrono::steady_clock::time_point start_time; ///< Время открытия камеры.
+    double last_timestamp = 0.0; ///< Время последнего кадра, с.
+};
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file FaceBudget.cpp
+ * @brief Реализация методов класса FaceBudget.
+ */
+
+#include <algorithm>
+#include <tuple>
+#include "FaceBudget.h"
+
+const std::string FaceBudget::PENDING_LABEL = "...";
+
+/**
+ * @brief Вычисляет перекрытие двух рамок (пересечение к объединению).
+ * @param a Первая рамка.
+ * @param b Вторая рамка.
+ * @return IoU от 0 до 1.
+ */
+static double intersectionOverUnion(const cv::Rect& a, const cv::Rect& b) {
+    double intersection = (a & b).area();
+    double united = static_cast<double>(a.area()) + b.area() - intersection;
+    return united > 0 ? intersection / united : 0.0;
+}
+
+/**
+ * @brief Разбирает название порядка лиц.
+ * @param name Название порядка.
+ * @param priority Порядок лиц.
+ * @return true, если название известно.
+ */
+bool FaceBudget::parsePriority(const std::string& name, Priority& priority) {
+    if (name == "largest") {
+        priority = LARGEST;
+    } else if (name == "central") {
+        priority = CENTRAL;
+    } else if (name == "oldest") {
+        priority = OLDEST;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Конструктор бюджета без ограничений.
+ */
+FaceBudget::FaceBudget() : FaceBudget(Settings()) {}
+
+/**
+ * @brief Конструктор бюджета.
+ * @param settings Параметры бюджета.
+ */
+FaceBudget::FaceBudget(const Settings& settings) : settings(settings) {}
+
+/**
+ * @brief Задаёт дополнительное ограничение числа предсказаний на кадр.
+ * @param max_faces Наибольшее число предсказаний на кадр; 0 снимает ограничение.
+ */
+void FaceBudget::setFrameLimit(size_t max_faces) {
+    frame_limit = max_faces;
+}
+
+/**
+ * @brief Ключ сортировки лица по приоритету: меньше - раньше.
+ * @param track Трек лица.
+ * @param frame_size Размер кадра.
+ * @return Ключ сортировки.
+ */
+double FaceBudget::priorityKey(const Track& track, cv::Size frame_size) const {
+    switch (settings.priority) {
+        case CENTRAL: {
+            double dx = track.box.x + track.box.width / 2.0 - frame_size.width / 2.0;
+            double dy = track.box.y + track.box.height / 2.0 - frame_size.height / 2.0;
+            return dx * dx + dy * dy;
+        }
+        case OLDEST: return -static_cast<double>(track.age);
+        default: return -static_cast<double>(track.box.area());
+    }
+}
+
+/**
+ * @brief Сопоставляет лица кадра с треками прошлого кадра и упорядочивает их по приоритету.
+ * @param faces Рамки лиц кадра.
+ * @param frame_size Размер кадра.
+ * @return Индексы лиц в порядке предсказаний.
+ */
+const std::vector<size_t>& FaceBudget::rank(const std::vector<cv::Rect>& faces, cv::Size frame_size) {
+    std::vector<Track> previous;
+    previous.swap(tracks);
+    tracks.assign(faces.size(), Track());
+
+    // Жадное сопоставление: сначала пары с наибольшим перекрытием
+    std::vector<std::tuple<double, size_t, size_t>> pairs;
+    for (size_t i = 0; i < faces.size(); i++) {
+        for (size_t j = 0; j < previous.size(); j++) {
+            double iou = intersectionOverUnion(faces[i], previous[j].box);
+            if (iou >= settings.match_iou) {
+                pairs.emplace_back(iou, i, j);
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) { return std::get<0>(a) > std::get<0>(b); });
+
+    std::vector<bool> matched_face(faces.size(), false);
+    std::vector<bool> matched_track(previous.size(), false);
+    for (const auto& pair : pairs) {
+        size_t face = std::get<1>(pair);
+        size_t track = std::get<2>(pair);
+        if (!matched_face[face] && !matched_track[track]) {
+            tracks[face] = previous[track];
+            matched_face[face] = true;
+            matched_track[track] = true;
+        }
+    }
+
+    std::vector<double> keys(faces.size());
+    for (size_t i = 0; i < faces.size(); i++) {
+        tracks[i].box = faces[i];
+        tracks[i].age++;
+        tracks[i].waiting++;
+        tracks[i].fresh = false;
+        keys[i] = priorityKey(tracks[i], frame_size);
+    }
+
+    // Лица, слишком долго ждущие предсказания, идут первыми, начиная с самого давнего
+    order.resize(faces.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        bool starving_a = tracks[a].waiting > settings.max_wait_frames;
+        bool starving_b = tracks[b].waiting > settings.max_wait_frames;
+        if (starving_a != starving_b) {
+            return starving_a;
+        }
+        if (starving_a) {
+            return tracks[a].waiting > tracks[b].waiting;
+        }
+        return keys[a] < keys[b];
+    });
+    return order;
+}
+
+/**
+ * @brief Проверяет, помещается ли в бюджет ещё одно предсказание.
+ * @param inferred Количество предсказаний на кадре.
+ * @param elapsed_ms Время этих предсказаний, мс.
+ * @return true, если можно выполнить ещё одно предсказание.
+ */
+bool FaceBudget::allows(size_t inferred, double elapsed_ms) const {
+    if (inferred == 0) {
+        return true;
+    }
+    if ((settings.max_faces > 0 && inferred >= settings.max_faces) || (frame_limit > 0 && inferred >= frame_limit)) {
+        return false;
+    }
+    return settings.max_ms <= 0 || elapsed_ms + elapsed_ms / inferred <= settings.max_ms;
+}
+
+/**
+ * @brief Сохраняет предсказание лица текущего кадра.
+ * @param face Индекс лица.
+ * @param label Подпись предсказания.
+ */
+void FaceBudget::setLabel(size_t face, const std::string& label) {
+    if (face < tracks.size()) {
+        tracks[face].label = label;
+        tracks[face].waiting = 0;
+        tracks[face].fresh = true;
+    }
+}
+
+/**
+ * @brief Получает подписи всех лиц текущего кадра и учитывает их в статистике.
+ * @return Подписи в порядке лиц.
+ */
+std::vector<std::string> FaceBudget::labels() {
+    std::vector<std::string> result;
+    result.reserve(tracks.size());
+    for (const Track& track : tracks) {
+        if (track.fresh) {
+            inferred_faces++;
+            result.push_back(track.label);
+        } else if (!track.label.empty()) {
+            carried_faces++;
+            result.push_back(track.label);
+        } else {
+            pending_faces++;
+            result.push_back(PENDING_LABEL);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Получает количество лиц с новым предсказанием.
+ * @return Количество лиц.
+ */
+uint64_t FaceBudget::inferredFaces() const {
+    return inferred_faces;
+}
+
+/**
+ * @brief Получает количество лиц с перенесённым предсказанием.
+ * @return Количество лиц.
+ */
+uint64_t FaceBudget::carriedFaces() const {
+    return carried_faces;
+}
+
+/**
+ * @brief Получает количество лиц, оставшихся без предсказания.
+ * @return Количество лиц.
+ */
+uint64_t FaceBudget::pendingFaces() const {
+    return pending_faces;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file FaceBudget.h
+ * @brief Объявление класса FaceBudget.
+ */
+
+#ifndef FACEBUDGET_H
+#define FACEBUDGET_H
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class FaceBudget
+ * @brief Бюджет предсказаний на кадр: ограничение по числу лиц или времени модели.
+ * Лица кадра сопоставляются с лицами прошлого кадра по перекрытию рамок и упорядочиваются
+ * по приоритету (размер, близость к центру или время в кадре). Модель получает лица по порядку,
+ * пока бюджет не исчерпан; остальные лица сохраняют последнее предсказание своего трека
+ * или помечаются как ожидающие. Лицо, слишком долго остававшееся без предсказания,
+ * ставится в начало очереди, чтобы в толпе подписи обновлялись у всех лиц по очереди.
+ */
+class FaceBudget {
+
+public:
+    /**
+     * @enum Priority
+     * @brief Порядок, в котором лица получают предсказания.
+     */
+    enum Priority {
+        LARGEST, ///< Сначала крупные лица.
+        CENTRAL, ///< Сначала лица ближе к центру кадра.
+        OLDEST ///< Сначала лица, дольше всех находящиеся в кадре.
+    };
+
+    /**
+     * @struct Settings
+     * @brief Параметры бюджета.
+     */
+    struct Settings {
+        Priority priority = LARGEST; ///< Порядок лиц.
+        size_t max_faces = 0; ///< Наибольшее число предсказаний на кадр (0 - без ограничения).
+        double max_ms = 0.0; ///< Наибольшее время предсказаний на кадр, мс (0 - без ограничения).
+        double match_iou = 0.3; ///< Наименьшее перекрытие (IoU) рамок одного лица на соседних кадрах.
+        int max_wait_frames = 15; ///< Лицо без предсказания дольше этого числа кадров идёт первым.
+    };
+
+    /**
+     * @brief Подпись лица, для которого ещё не было предсказания.
+     */
+    static const std::string PENDING_LABEL;
+
+    /**
+     * @brief Разбирает название порядка лиц.
+     * @param name Название: "largest", "central" или "oldest".
+     * @param priority Порядок лиц.
+     * @return true, если название известно.
+     */
+    static bool parsePriority(const std::string& name, Priority& priority);
+
+    /**
+     * @brief Конструктор бюджета без ограничений.
+     */
+    FaceBudget();
+
+    /**
+     * @brief Конструктор бюджета.
+     * @param settings Параметры бюджета.
+     */
+    explicit FaceBudget(const Settings& settings);
+
+    /**
+     * @brief Задаёт дополнительное ограничение числа предсказаний на кадр (например, от регулятора качества).
+     * Действует вместе с Settings::max_faces: применяется меньшее из ненулевых ограничений.
+     * @param max_faces Наибольшее число предсказаний на кадр; 0 снимает ограничение.
+     */
+    void setFrameLimit(size_t max_faces);
+
+    /**
+     * @brief Сопоставляет лица кадра с треками прошлого кадра и упорядочивает их по приоритету.
+     * Вызывается один раз на кадр с предсказаниями, до setLabel.
+     * @param faces Рамки лиц кадра.
+     * @param frame_size Размер кадра.
+     * @return Индексы лиц в порядке предсказаний.
+     */
+    const std::vector<size_t>& rank(const std::vector<cv::Rect>& faces, cv::Size frame_size);
+
+    /**
+     * @brief Проверяет, помещается ли в бюджет ещё одно предсказание.
+     * Время следующего предсказания оценивается по среднему времени уже выполненных
+     * на этом кадре; первое предсказание кадра выполняется всегда.
+     * @param inferred Количество предсказаний на кадре.
+     * @param elapsed_ms Время этих предсказаний, мс.
+     * @return true, если можно выполнить ещё одно предсказание.
+     */
+    bool allows(size_t inferred, double elapsed_ms) const;
+
+    /**
+     * @brief Сохраняет предсказание лица текущего кадра.
+     * @param face Индекс лица в векторе, переданном в rank.
+     * @param label Подпись предсказания.
+     */
+    void setLabel(size_t face, const std::string& label);
+
+    /**
+     * @brief Получает подписи всех лиц текущего кадра и учитывает их в статистике.
+     * Вызывается один раз на кадр после всех setLabel.
+     * @return Для каждого лица: новое предсказание, перенесённое с прошлых кадров или PENDING_LABEL.
+     */
+    std::vector<std::string> labels();
+
+    /**
+     * @brief Получает количество лиц с новым предсказанием.
+     * @return Количество лиц по всем кадрам.
+     */
+    uint64_t inferredFaces() const;
+
+    /**
+     * @brief Получает количество лиц с перенесённым предсказанием.
+     * @return Количество лиц по всем кадрам.
+     */
+    uint64_t carriedFaces() const;
+
+    /**
+     * @brief Получает количество лиц, оставшихся без предсказания.
+     * @return Количество лиц по всем кадрам.
+     */
+    uint64_t pendingFaces() const;
+
+private:
+    /**
+     * @struct Track
+     * @brief Лицо, сопоставленное между кадрами.
+     */
+    struct Track {
+        cv::Rect box; ///< Рамка на последнем кадре.
+        uint64_t age = 0; ///< Количество кадров, на которых найдено лицо.
+        int waiting = 0; ///< Кадров с последнего предсказания.
+        std::string label; ///< Последнее предсказание (пусто - ещё не было).
+        bool fresh = false; ///< Предсказание получено на текущем кадре.
+    };
+
+    double priorityKey(const Track& track, cv::Size frame_size) const;
+
+    Settings settings; ///< Параметры бюджета.
+    std::vector<Track> tracks; ///< Треки в порядке лиц текущего кадра.
+    std::vector<size_t> order; ///< Индексы лиц в порядке предсказаний.
+    size_t frame_limit = 0; ///< Дополнительное ограничение числа предсказаний на кадр (0 - без ограничения).
+    uint64_t inferred_faces = 0; ///< Лиц с новым предсказанием.
+    uint64_t carried_faces = 0; ///< Лиц с перенесённым предсказанием.
+    uint64_t pending_faces = 0; ///< Лиц без предсказания.
+};
+
+#endif
@@ -3,87 +3,320 @@
  * @brief Реализация методов класса FaceDetector.
  */
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <iostream>
 #include "FaceDetector.h"
 #include "Image.h"
 
 /**
  * @brief Конструктор класса FaceDetector.
  * Загружает каскадный классификатор.
+ * @param cascade_filename Путь к XML-файлу каскадного классификатора.
  */
-FaceDetector::FaceDetector() {
+FaceDetector::FaceDetector(const std::string& cascade_filename) : cascade_filename(cascade_filename) {
     // Загрузка каскадного классификатора
-    cascade.load(FACE_DETECTOR_MODEL_PATH);
+    if (!loadCascade(cascade)) {
+        std::cerr << "Unable to load face cascade " << cascade_filename << std::endl;
+    }
+}
+
+/**
+ * @brief Конструктор класса FaceDetector.
+ * Загружает каскадный классификатор из пакета моделей.
+ * @param bundle Открытый пакет моделей.
+ */
+FaceDetector::FaceDetector(const ModelBundle& bundle) {
+    const char* data = nullptr;
+    size_t size = 0;
+    if (bundle.find(ModelBundle::CASCADE_ENTRY, data, size)) {
+        cascade_xml.assign(data, size);
+    }
+
+    // Загрузка каскадного классификатора из памяти без чтения файла
+    if (!loadCascade(cascade)) {
+        std::cerr << "Unable to load face cascade from model bundle" << std::endl;
+    }
+}
+
+/**
+ * @brief Загружает каскадный классификатор из файла или из содержимого пакета моделей.
+ * @param target Каскадный классификатор, который нужно загрузить.
+ * @return true, если каскад загружен.
+ */
+bool FaceDetector::loadCascade(cv::CascadeClassifier& target) const {
+    if (!cascade_filename.empty()) {
+        return target.load(cascade_filename);
+    }
+
+    if (cascade_xml.empty()) {
+        return false;
+    }
+
+    cv::FileStorage storage(cascade_xml, cv::FileStorage::READ | cv::FileStorage::MEMORY);
+    return storage.isOpened() && target.read(storage.getFirstTopLevelNode());
 }
 
 /**
  * @brief Обнаружение лиц на изображении.
  * @param frame Изображение, на котором нужно обнаружить лица.
+ * @return Рамки вокруг обнаруженных лиц.
  */
-void FaceDetector::detectFace(cv::Mat& frame) {
-    cv::Mat gray_img;
-    cv::cvtColor(frame, gray_img, cv::COLOR_BGR2GRAY);
-    cv::equalizeHist(gray_img, gray_img);
+const std::vector<cv::Rect>& FaceDetector::detectFace(const cv::Mat& frame) {
+    // Единственная конвертация цвета на кадр: плоскость яркости используется и для ROI.
+    // Одноканальный кадр используется как есть, конвертация идёт в собственный буфер,
+    // чтобы не записать поверх кадра, переданного ранее
+    if (frame.channels() == 1) {
+        gray = frame;
+    } else {
+        Image::toGray(frame, gray_buffer);
+        gray = gray_buffer;
+    }
+    cv::equalizeHist(gray, equalized);
 
     // Обнаружение лиц
-    cascade.detectMultiScale(gray_img, this->faces, 1.1, 2, 0|cv::CASCADE_SCALE_IMAGE, cv::Size(100, 100));
+    if (tile_pool && equalized.cols >= tile_min_frame_width) {
+        detectTiled();
+    } else {
+        cascade.detectMultiScale(equalized, this->faces, scale_factor, min_neighbors, 0|cv::CASCADE_SCALE_IMAGE, min_face_size);
+    }
+
+    return faces;
 }
 
 /**
- * @brief Рисует рамку вокруг обнаруженных лиц на изображении.
- * @param frame Изображение, на котором нужно нарисовать рамку.
- * @return Изображение с нанесенными рамками и областью интереса (ROI).
+ * @brief Включает тайловую детекцию для больших кадров.
+ * @param threads Количество потоков; 0 отключает тайловую детекцию.
+ * @param max_tile_face Максимальный размер лица, которое ищется в тайлах.
+ * @param min_frame_width Минимальная ширина кадра, начиная с которой используются тайлы.
  */
-Image FaceDetector::drawBoundingBoxOnFrame(cv::Mat& frame) {
-    Image image_and_ROI;
+void FaceDetector::setTiling(size_t threads, cv::Size max_tile_face, int min_frame_width) {
+    tile_pool.reset();
+    if (threads > 0) {
+        tile_pool.reset(new ThreadPool(threads));
+    }
+    this->max_tile_face = cv::Size(std::max(max_tile_face.width, min_face_size.width),
+                                   std::max(max_tile_face.height, min_face_size.height));
+    tile_min_frame_width = min_frame_width;
+}
 
-    // Для каждого обнаруженного лица рисуется рамка
-    if (faces.size() > 0) {
-        for (int i = 0; i < faces.size(); i++) {
-            cv::Rect r = faces[i];
+/**
+ * @brief Задаёт параметры пирамиды каскада.
+ * @param scale_factor Шаг масштаба пирамиды каскада.
+ * @param min_face_size Минимальный размер лица.
+ */
+void FaceDetector::setScale(double scale_factor, cv::Size min_face_size) {
+    this->scale_factor = scale_factor;
+    this->min_face_size = min_face_size;
+    // Лица в тайлах не могут быть меньше минимального размера
+    max_tile_face = cv::Size(std::max(max_tile_face.width, min_face_size.width),
+                             std::max(max_tile_face.height, min_face_size.height));
+}
 
-            // Рисование прямоугольника вокруг лица
-            rectangle(frame,
-                      cv::Point(r.x, r.y),
-                      cv::Point(r.x + r.width, r.y + r.height),
-                      cv::Scalar(255, 0, 0), 3, 8, 0);
+/**
+ * @brief Доля перекрытия двух рамок относительно меньшей из них.
+ * @param a Первая рамка.
+ * @param b Вторая рамка.
+ * @return Площадь пересечения, делённая на площадь меньшей рамки.
+ */
+static double overlapRatio(const cv::Rect& a, const cv::Rect& b) {
+    double intersection = (a & b).area();
+    double smaller = std::min(a.area(), b.area());
+    return smaller > 0 ? intersection / smaller : 0.0;
+}
 
-            cv::Rect roi_coord(r.x, r.y, r.width, r.height);
-            cv::Mat roi_image = frame(roi_coord);
+/**
+ * @brief Объединяет рамки одного лица, найденные в соседних тайлах или разными проходами.
+ * Из группы перекрывающихся рамок остаётся наибольшая: рамка лица, обрезанного краем тайла,
+ * всегда меньше рамки того же лица из тайла, в который оно попало целиком.
+ * @param rects Рамки в координатах кадра.
+ * @return Объединённые рамки.
+ */
+static std::vector<cv::Rect> mergeDetections(std::vector<cv::Rect> rects) {
+    std::sort(rects.begin(), rects.end(), [](const cv::Rect& a, const cv::Rect& b) {
+        return a.area() > b.area();
+    });
 
-            image_and_ROI.setROI(roi_image);
-            image_and_ROI.setFrame(frame);
+    std::vector<cv::Rect> merged;
+    for (const cv::Rect& r : rects) {
+        bool duplicate = false;
+        for (int i = 0; i < merged.size() && !duplicate; i++) {
+            duplicate = overlapRatio(r, merged[i]) > 0.5;
+        }
+        if (!duplicate) {
+            merged.push_back(r);
         }
     }
 
-    return image_and_ROI;
+    return merged;
 }
 
 /**
- * @brief Печатает текст с предсказанием эмоций на изображении.
- * @param image_and_ROI Изображение с рамками вокруг лиц.
- * @param emotion_prediction Вектор строк с предсказанными эмоциями.
- * @return Изображение с текстом предсказаний.
+ * @brief Тайловая детекция лиц на выровненной плоскости яркости в пуле потоков.
  */
-Image FaceDetector::printPredictionTextToFrame(Image& image_and_ROI, std::vector<std::string>& emotion_prediction) {
-    cv::Mat img = image_and_ROI.getFrame();
+void FaceDetector::detectTiled() {
+    cv::Size frame_size(equalized.cols, equalized.rows);
+    int overlap_x = max_tile_face.width;
+    int overlap_y = max_tile_face.height;
+
+    // Сетка примерно из стольких ячеек, сколько потоков, с ячейками, близкими к квадрату.
+    // Тайл - ячейка, расширенная на максимальный размер лица вправо и вниз, поэтому каждое лицо
+    // не крупнее этого размера целиком попадает в тайл ячейки, содержащей его левый верхний угол
+    double threads = static_cast<double>(tile_pool->size());
+    int cols = std::max(1, static_cast<int>(std::round(std::sqrt(threads * frame_size.width / frame_size.height))));
+    int rows = std::max(1, static_cast<int>(std::ceil(threads / cols)));
+    int cell_width = (frame_size.width + cols - 1) / cols;
+    int cell_height = (frame_size.height + rows - 1) / rows;
+
+    std::vector<std::future<std::vector<cv::Rect>>> results;
 
-    if (faces.size() > 0) {
-        for (int i = 0; i < faces.size(); i++) {
-            cv::Rect r = faces[i];
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            cv::Rect tile(col * cell_width, row * cell_height, cell_width + overlap_x, cell_height + overlap_y);
+            tile &= cv::Rect(0, 0, frame_size.width, frame_size.height);
+            if (tile.width < min_face_size.width || tile.height < min_face_size.height) {
+                continue;
+            }
 
-            // Написание текста с предсказанием на рамке
-            cv::putText(img, // целевое изображение
-                        emotion_prediction[i], // текст - результат работы модели
-                        cv::Point(r.x, r.y - 10), // верхняя левая позиция рамки
-                        cv::FONT_HERSHEY_DUPLEX,
-                        1.0,
-                        CV_RGB(118, 185, 0), // цвет шрифта
-                        2);
+            results.push_back(tile_pool->submit([this, tile]() {
+                std::vector<cv::Rect> tile_faces;
+                cv::CascadeClassifier* tile_cascade = acquireTileCascade();
+                tile_cascade->detectMultiScale(equalized(tile), tile_faces, scale_factor, min_neighbors,
+                                               0|cv::CASCADE_SCALE_IMAGE, min_face_size, max_tile_face);
+                releaseTileCascade(tile_cascade);
+
+                // Перевод в координаты кадра
+                for (cv::Rect& r : tile_faces) {
+                    r.x += tile.x;
+                    r.y += tile.y;
+                }
+                return tile_faces;
+            }));
         }
     }
 
-    image_and_ROI.setFrame(img);
+    // Лица крупнее максимального размера для тайлов ищутся по всему кадру начиная с крупного масштаба
+    results.push_back(tile_pool->submit([this]() {
+        std::vector<cv::Rect> large_faces;
+        cv::CascadeClassifier* tile_cascade = acquireTileCascade();
+        tile_cascade->detectMultiScale(equalized, large_faces, scale_factor, min_neighbors,
+                                       0|cv::CASCADE_SCALE_IMAGE, max_tile_face);
+        releaseTileCascade(tile_cascade);
+        return large_faces;
+    }));
+
+    std::vector<cv::Rect> all_faces;
+    for (auto& result : results) {
+        std::vector<cv::Rect> part = result.get();
+        all_faces.insert(all_faces.end(), part.begin(), part.end());
+    }
+
+    faces = mergeDetections(all_faces);
+}
+
+/**
+ * @brief Получает свободную копию каскада для потока тайла, загружая новую при необходимости.
+ * CascadeClassifier не допускает одновременных вызовов detectMultiScale, поэтому каждый поток работает со своей копией.
+ * @return Копия каскада.
+ */
+cv::CascadeClassifier* FaceDetector::acquireTileCascade() {
+    {
+        std::lock_guard<std::mutex> lock(tile_cascades_mutex);
+        if (!free_tile_cascades.empty()) {
+            cv::CascadeClassifier* tile_cascade = free_tile_cascades.back();
+            free_tile_cascades.pop_back();
+            return tile_cascade;
+        }
+    }
+
+    // Загрузка выполняется вне мьютекса, копий не больше, чем потоков в пуле
+    std::unique_ptr<cv::CascadeClassifier> tile_cascade(new cv::CascadeClassifier());
+    loadCascade(*tile_cascade);
+    cv::CascadeClassifier* result = tile_cascade.get();
+
+    std::lock_guard<std::mutex> lock(tile_cascades_mutex);
+    tile_cascades.push_back(std::move(tile_cascade));
+    return result;
+}
+
+/**
+ * @brief Возвращает копию каскада в список свободных.
+ * @param tile_cascade Копия каскада.
+ */
+void FaceDetector::releaseTileCascade(cv::CascadeClassifier* tile_cascade) {
+    std::lock_guard<std::mutex> lock(tile_cascades_mutex);
+    free_tile_cascades.push_back(tile_cascade);
+}
+
+/**
+ * @brief Выделяет области интереса (ROI) обнаруженных лиц.
+ * @param frame Кадр, на котором были обнаружены лица.
+ * @return Изображение с исходным кадром и областями интереса (ROI).
+ */
+Image FaceDetector::extractROI(const cv::Mat& frame) const {
+    Image image_and_ROI;
+
+    // Для каждого обнаруженного лица выделяется ROI плоскости яркости без копирования пикселей
+    for (int i = 0; i < faces.size(); i++) {
+        cv::Mat roi_image = gray(faces[i]);
+        image_and_ROI.setROI(roi_image);
+    }
+
+    cv::Mat clean_frame = frame;
+    image_and_ROI.setFrame(clean_frame);
+
+    return image_and_ROI;
+}
+
+/**
+ * @brief Выделяет области интереса только для лиц, прошедших оценку качества.
+ * @param frame Исходный кадр.
+ * @param quality Оценка качества лиц.
+ * @param scores Оценки всех найденных лиц.
+ * @return Изображение с исходным кадром и ROI принятых лиц.
+ */
+Image FaceDetector::extractROI(const cv::Mat& frame, const FaceQuality& quality,
+                               std::vector<FaceQuality::Score>& scores) const {
+    Image image_and_ROI;
+    scores.clear();
+
+    // Отклонённые лица не попадают во вход модели
+    for (int i = 0; i < faces.size(); i++) {
+        cv::Mat roi_image = gray(faces[i]);
+        scores.push_back(quality.evaluate(roi_image, faces[i], gray.size()));
+        if (scores.back().accepted()) {
+            image_and_ROI.setROI(roi_image);
+        }
+    }
+
+    cv::Mat clean_frame = frame;
+    image_and_ROI.setFrame(clean_frame);
 
     return image_and_ROI;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Возвращает плоскость яркости последнего кадра, переданного в detectFace.
+ * @return Кадр в градациях серого.
+ */
+const cv::Mat& FaceDetector::getGray() const {
+    return gray;
+}
+
+/**
+ * @brief Возвращает рамки лиц, найденных последним вызовом detectFace.
+ * @return Вектор рамок вокруг лиц.
+ */
+const std::vector<cv::Rect>& FaceDetector::getFaces() const {
+    return faces;
+}
+
+/**
+ * @brief Возвращает количество лиц, найденных последним вызовом detectFace.
+ * @return Количество обнаруженных лиц.
+ */
+size_t FaceDetector::faceCount() const {
+    return faces.size();
+}
@@ -6,48 +6,123 @@
 #ifndef FACEDETECTOR_H
 #define FACEDETECTOR_H
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/objdetect.hpp>
+#include <memory>
+#include <mutex>
+#include "FaceQuality.h"
 #include "Image.h"
-
-extern const std::string FACE_DETECTOR_MODEL_PATH;
+#include "ModelBundle.h"
+#include "ThreadPool.h"
 
 /**
  * @class FaceDetector
  * @brief Класс для обнаружения лиц на изображениях с использованием каскадного классификатора.
- * Также этот класс рисует рамку и текст предсказания на изображении.
+ * Детектор только возвращает геометрию лиц и никогда не изменяет исходный кадр,
+ * рамки и текст предсказаний рисует FrameRenderer.
  */
 class FaceDetector {
 
 public:
     /**
      * @brief Конструктор загружает каскадный классификатор для обнаружения лиц.
+     * @param cascade_filename Путь к XML-файлу каскадного классификатора.
+     */
+    explicit FaceDetector(const std::string& cascade_filename);
+
+    /**
+     * @brief Конструктор загружает каскадный классификатор из пакета моделей, отображённого в память.
+     * @param bundle Открытый пакет моделей с записью ModelBundle::CASCADE_ENTRY.
      */
-    FaceDetector();
+    explicit FaceDetector(const ModelBundle& bundle);
 
     /**
-     * @brief Обнаружение лиц на изображении и рисование рамок.
-     * @param frame Изображение, на котором нужно обнаружить лица.
+     * @brief Обнаружение лиц на изображении.
+     * Плоскость яркости кадра вычисляется один раз и сохраняется для выделения ROI.
+     * @param frame Изображение, на котором нужно обнаружить лица (BGR, BGRA, YUYV или плоскость яркости).
+     * @return Рамки вокруг обнаруженных лиц.
      */
-    void detectFace(cv::Mat& frame);
+    const std::vector<cv::Rect>& detectFace(const cv::Mat& frame);
 
     /**
-     * @brief Рисует рамку вокруг обнаруженных лиц на изображении.
-     * @param frame Изображение, на котором нужно нарисовать рамку.
-     * @return Изображение с нанесенными рамками и областью интереса (ROI).
+     * @brief Включает тайловую детекцию для больших кадров (например, 4K).
+     * Кадр делится на перекрывающиеся тайлы (перекрытие равно максимальному размеру лица в тайле),
+     * каскад запускается на каждом тайле в пуле потоков, а лица крупнее этого размера ищутся
+     * отдельным проходом по всему кадру, начинающимся сразу с крупного масштаба.
+     * Результаты объединяются, из дубликатов на швах тайлов остаётся наибольшая рамка.
+     * @param threads Количество потоков; 0 отключает тайловую детекцию.
+     * @param max_tile_face Максимальный размер лица, которое ищется в тайлах.
+     * @param min_frame_width Минимальная ширина кадра, начиная с которой используются тайлы.
      */
-    Image drawBoundingBoxOnFrame(cv::Mat& frame);
+    void setTiling(size_t threads, cv::Size max_tile_face = cv::Size(400, 400), int min_frame_width = 2560);
 
     /**
-     * @brief Печатает текст с предсказанием эмоций на изображении.
-     * @param image_and_ROI Изображение с рамками вокруг лиц.
-     * @param emotion_prediction Вектор строк с предсказанными эмоциями.
-     * @return Изображение с текстом предсказаний.
+     * @brief Задаёт параметры пирамиды каскада (например, для загрубления детекции под нагрузкой).
+     * @param scale_factor Шаг масштаба пирамиды каскада.
+     * @param min_face_size Минимальный размер лица.
      */
-    Image printPredictionTextToFrame(Image& image_and_ROI, std::vector<std::string>& emotion_prediction);
+    void setScale(double scale_factor, cv::Size min_face_size);
+
+    /**
+     * @brief Выделяет области интереса (ROI) обнаруженных лиц.
+     * ROI являются представлениями плоскости яркости, вычисленной в detectFace, без копирования
+     * и без повторной конвертации цвета. Они действительны до следующего вызова detectFace
+     * и могут разделяться между потоками предобработки только для чтения.
+     * @param frame Кадр, на котором были обнаружены лица.
+     * @return Изображение с исходным кадром и областями интереса (ROI).
+     */
+    Image extractROI(const cv::Mat& frame) const;
+
+    /**
+     * @brief Выделяет области интереса только для лиц, прошедших оценку качества.
+     * @param frame Исходный кадр, переданный в detectFace.
+     * @param quality Оценка качества лиц.
+     * @param scores Оценки всех найденных лиц в порядке рамок (см. FaceQuality::labelFaces).
+     * @return Изображение с исходным кадром и ROI принятых лиц.
+     */
+    Image extractROI(const cv::Mat& frame, const FaceQuality& quality, std::vector<FaceQuality::Score>& scores) const;
+
+    /**
+     * @brief Возвращает плоскость яркости последнего кадра, переданного в detectFace.
+     * @return Кадр в градациях серого (без выравнивания гистограммы).
+     */
+    const cv::Mat& getGray() const;
+
+    /**
+     * @brief Возвращает рамки лиц, найденных последним вызовом detectFace.
+     * @return Вектор рамок вокруг лиц.
+     */
+    const std::vector<cv::Rect>& getFaces() const;
+
+    /**
+     * @brief Возвращает количество лиц, найденных последним вызовом detectFace.
+     * @return Количество обнаруженных лиц.
+     */
+    size_t faceCount() const;
 
 private:
+    bool loadCascade(cv::CascadeClassifier& target) const;
+    void detectTiled();
+    cv::CascadeClassifier* acquireTileCascade();
+    void releaseTileCascade(cv::CascadeClassifier* tile_cascade);
+
+    std::string cascade_filename; ///< Путь к каскаду для загрузки копий в потоках тайлов.
+    std::string cascade_xml; ///< Содержимое каскада из пакета моделей для загрузки копий в потоках тайлов.
     cv::CascadeClassifier cascade; ///< Каскадный классификатор для обнаружения лиц.
+    double scale_factor = 1.1; ///< Шаг масштаба пирамиды каскада.
+    int min_neighbors = 2; ///< Минимальное количество соседних срабатываний для лица.
+    cv::Size min_face_size = cv::Size(100, 100); ///< Минимальный размер лица.
     std::vector<cv::Rect> faces; ///< Результаты обнаружения лиц.
+    cv::Mat gray; ///< Плоскость яркости последнего кадра.
+    cv::Mat gray_buffer; ///< Буфер для конвертации цветных кадров в градации серого.
+    cv::Mat equalized; ///< Плоскость яркости с выровненной гистограммой для каскада.
+
+    std::unique_ptr<ThreadPool> tile_pool; ///< Пул потоков тайловой детекции.
+    cv::Size max_tile_face; ///< Максимальный размер лица в тайле (и перекрытие тайлов).
+    int tile_min_frame_width = 0; ///< Минимальная ширина кадра для тайловой детекции.
+    std::vector<std::unique_ptr<cv::CascadeClassifier>> tile_cascades; ///< Копии каскада для потоков тайлов.
+    std::vector<cv::CascadeClassifier*> free_tile_cascades; ///< Свободные копии каскада.
+    std::mutex tile_cascades_mutex; ///< Защита списка свободных копий каскада.
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file FaceQuality.cpp
+ * @brief Реализация методов класса FaceQuality.
+ */
+
+#include <opencv2/imgproc.hpp>
+#include "FaceQuality.h"
+
+/**
+ * @brief Размер, к которому приводится лицо перед оценкой контраста и резкости,
+ * чтобы пороги не зависели от размера рамки.
+ */
+static const cv::Size QUALITY_PROBE_SIZE(64, 64);
+
+/**
+ * @brief Конструктор с порогами по умолчанию.
+ */
+FaceQuality::FaceQuality() {}
+
+/**
+ * @brief Конструктор класса FaceQuality.
+ * @param settings Пороги оценки качества.
+ */
+FaceQuality::FaceQuality(const Settings& settings) : settings(settings) {}
+
+/**
+ * @brief Оценивает лицо.
+ * @param gray_roi Лицо в градациях серого.
+ * @param face Рамка лица в кадре.
+ * @param frame_size Размер кадра.
+ * @return Результат оценки.
+ */
+FaceQuality::Score FaceQuality::evaluate(const cv::Mat& gray_roi, const cv::Rect& face, cv::Size frame_size) const {
+    Score score;
+
+    if (face.width < settings.min_size || face.height < settings.min_size || gray_roi.empty()) {
+        score.reason = TOO_SMALL;
+        return score;
+    }
+
+    // Каскад не выходит за кадр, поэтому обрезанное лицо упирается рамкой в край
+    int margin = settings.border_margin;
+    if (face.x <= margin || face.y <= margin ||
+        face.x + face.width >= frame_size.width - margin ||
+        face.y + face.height >= frame_size.height - margin) {
+        score.reason = TRUNCATED;
+        return score;
+    }
+
+    // Уменьшенная копия: и дешевле, и пороги не зависят от размера лица
+    cv::Mat probe;
+    cv::resize(gray_roi, probe, QUALITY_PROBE_SIZE, 0, 0, cv::INTER_AREA);
+
+    cv::Scalar mean;
+    cv::Scalar deviation;
+    cv::meanStdDev(probe, mean, deviation);
+    score.contrast = deviation[0];
+    if (score.contrast < settings.min_contrast) {
+        score.reason = LOW_CONTRAST;
+        return score;
+    }
+
+    cv::Mat laplacian;
+    cv::Laplacian(probe, laplacian, CV_16S);
+    cv::meanStdDev(laplacian, mean, deviation);
+    score.sharpness = deviation[0] * deviation[0];
+    if (score.sharpness < settings.min_sharpness) {
+        score.reason = BLURRY;
+    }
+    return score;
+}
+
+/**
+ * @brief Получает название причины отказа.
+ * @param reason Причина.
+ * @return Название причины.
+ */
+std::string FaceQuality::reasonName(Reason reason) {
+    switch (reason) {
+    case ACCEPTED:
+        return "accepted";
+    case TOO_SMALL:
+        return "too small";
+    case TRUNCATED:
+        return "truncated";
+    case LOW_CONTRAST:
+        return "low contrast";
+    case BLURRY:
+        return "blurry";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * @brief Сопоставляет предсказания для принятых лиц со всеми лицами кадра.
+ * @param scores Оценки всех лиц.
+ * @param predictions Предсказания для принятых лиц.
+ * @return Подпись для каждого лица.
+ */
+std::vector<std::string> FaceQuality::labelFaces(const std::vector<Score>& scores,
+                                                 const std::vector<std::string>& predictions) {
+    std::vector<std::string> labels;
+    size_t next = 0;
+    for (const Score& score : scores) {
+        if (!score.accepted()) {
+            labels.push_back("skipped: " + reasonName(score.reason));
+        } else if (next < predictions.size()) {
+            labels.push_back(predictions[next++]);
+        } else {
+            labels.push_back("");
+        }
+    }
+    return labels;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file FaceQuality.h
+ * @brief Объявление класса FaceQuality.
+ */
+
+#ifndef FACEQUALITY_H
+#define FACEQUALITY_H
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @class FaceQuality
+ * @brief Быстрая оценка качества вырезанного лица перед предсказанием.
+ * Отбрасывает слишком маленькие лица, лица, обрезанные краем кадра, малоконтрастные
+ * и размытые (по дисперсии лапласиана). Для таких лиц сеть выдаёт случайные метки,
+ * поэтому прямой проход для них не выполняется.
+ */
+class FaceQuality {
+
+public:
+    /**
+     * @brief Причина отказа.
+     */
+    enum Reason {
+        ACCEPTED = 0, ///< Лицо пригодно для предсказания.
+        TOO_SMALL, ///< Рамка меньше минимального размера.
+        TRUNCATED, ///< Рамка касается края кадра.
+        LOW_CONTRAST, ///< Слишком низкий контраст.
+        BLURRY, ///< Слишком размытое изображение.
+        REASON_COUNT ///< Количество значений перечисления.
+    };
+
+    /**
+     * @struct Settings
+     * @brief Пороги оценки качества.
+     */
+    struct Settings {
+        int min_size = 48; ///< Минимальная сторона рамки, пикселей (не меньше входа модели).
+        int border_margin = 2; ///< Рамка ближе к краю кадра считается обрезанной, пикселей.
+        double min_contrast = 12.0; ///< Минимальное стандартное отклонение яркости (0-255).
+        double min_sharpness = 15.0; ///< Минимальная дисперсия лапласиана на лице 64x64.
+    };
+
+    /**
+     * @struct Score
+     * @brief Результат оценки одного лица.
+     */
+    struct Score {
+        Reason reason = ACCEPTED; ///< Причина отказа или ACCEPTED.
+        double contrast = 0.0; ///< Стандартное отклонение яркости.
+        double sharpness = 0.0; ///< Дисперсия лапласиана.
+
+        /**
+         * @brief Проверяет, пригодно ли лицо для предсказания.
+         * @return true, если лицо принято.
+         */
+        bool accepted() const { return reason == ACCEPTED; };
+    };
+
+    /**
+     * @brief Конструктор с порогами по умолчанию.
+     */
+    FaceQuality();
+
+    /**
+     * @brief Конструктор класса FaceQuality.
+     * @param settings Пороги оценки качества.
+     */
+    explicit FaceQuality(const Settings& settings);
+
+    /**
+     * @brief Оценивает лицо. Проверки идут от дешёвых к дорогим и останавливаются на первом отказе.
+     * @param gray_roi Лицо в градациях серого.
+     * @param face Рамка лица в кадре.
+     * @param frame_size Размер кадра.
+     * @return Результат оценки.
+     */
+    Score evaluate(const cv::Mat& gray_roi, const cv::Rect& face, cv::Size frame_size) const;
+
+    /**
+     * @brief Получает название причины отказа.
+     * @param reason Причина.
+     * @return Название (например, "blurry").
+     */
+    static std::string reasonName(Reason reason);
+
+    /**
+     * @brief Сопоставляет предсказания для принятых лиц со всеми лицами кадра.
+     * @param scores Оценки всех лиц в порядке рамок.
+     * @param predictions Предсказания только для принятых лиц, в том же порядке.
+     * @return Подпись для каждого лица: предсказание или причина отказа.
+     */
+    static std::vector<std::string> labelFaces(const std::vector<Score>& scores,
+                                               const std::vector<std::string>& predictions);
+
+private:
+    Settings settings; ///< Пороги оценки качества.
+};
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file FrameClassifier.cpp
+ * @brief Реализация методов класса FrameClassifier.
+ */
+
+#include <utility>
+#include "FrameClassifier.h"
+
+/**
+ * @brief Конструктор класса FrameClassifier.
+ * @param face_detector Детектор лиц.
+ * @param predictor Предсказание для ROI.
+ * @param quality_gate Не передавать в модель непригодные лица.
+ */
+FrameClassifier::FrameClassifier(FaceDetector& face_detector, Predictor predictor, bool quality_gate)
+    : face_detector(face_detector), predictor(std::move(predictor)), quality_gate(quality_gate) {}
+
+/**
+ * @brief Находит лица кадра и классифицирует пригодные.
+ * @param frame Кадр.
+ * @return ID класса первого классифицированного лица или -1.
+ */
+int FrameClassifier::classify(const cv::Mat& frame) {
+    const std::vector<cv::Rect>& detected = face_detector.detectFace(frame);
+    last_faces.clear();
+    last_predictions.clear();
+
+    // Если все лица непригодны, кадр не получает класса вместо случайной метки
+    Image image_and_ROI = extractFaces(face_detector, frame, quality_gate, quality, last_scores);
+    if (image_and_ROI.getROI().empty()) {
+        return -1;
+    }
+    for (size_t i = 0; i < detected.size(); i++) {
+        if (last_scores[i].accepted()) {
+            last_faces.push_back(detected[i]);
+        }
+    }
+
+    image_and_ROI.preprocessROI();
+    last_predictions = predictor(image_and_ROI);
+    return last_predictions.empty() ? -1 : last_predictions[0].class_id;
+}
+
+/**
+ * @brief Получает рамки классифицированных лиц последнего кадра.
+ * @return Рамки в порядке предсказаний.
+ */
+const std::vector<cv::Rect>& FrameClassifier::faces() const {
+    return last_faces;
+}
+
+/**
+ * @brief Получает предсказания последнего кадра.
+ * @return Предсказания в порядке рамок.
+ */
+const std::vector<EmotionPrediction>& FrameClassifier::predictions() const {
+    return last_predictions;
+}
+
+/**
+ * @brief Получает оценки качества всех найденных лиц последнего кадра.
+ * @return Оценки в порядке рамок детектора.
+ */
+const std::vector<FaceQuality::Score>& FrameClassifier::scores() const {
+    return last_scores;
+}
+
+/**
+ * @brief Выделяет ROI найденных лиц; при включённой оценке качества - только пригодных.
+ * @param face_detector Детектор лиц после detectFace.
+ * @param frame Исходный кадр.
+ * @param quality_gate Не передавать в модель непригодные лица.
+ * @param quality Оценка качества лиц.
+ * @param scores Оценки всех найденных лиц в порядке рамок.
+ * @return Изображение с ROI для модели.
+ */
+Image FrameClassifier::extractFaces(const FaceDetector& face_detector, const cv::Mat& frame, bool quality_gate,
+                                    const FaceQuality& quality, std::vector<FaceQuality::Score>& scores) {
+    if (quality_gate) {
+        return face_detector.extractROI(frame, quality, scores);
+    }
+    scores.assign(face_detector.faceCount(), FaceQuality::Score());
+    return face_detector.extractROI(frame);
+}
+
+/**
+ * @brief Считает секунды видео, которые получают класс последнего обработанного кадра.
+ * @param time Позиция обработанного кадра, с.
+ * @param next_record Следующая секунда видео без записи.
+ * @return Количество новых записей.
+ */
+size_t FrameClassifier::recordSeconds(double time, double& next_record) {
+    size_t count = 0;
+    for (; next_record <= time; next_record += 1.0) {
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file FrameClassifier.h
+ * @brief Объявление класса FrameClassifier.
+ */
+
+#ifndef FRAMECLASSIFIER_H
+#define FRAMECLASSIFIER_H
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "FaceDetector.h"
+#include "FaceQuality.h"
+#include "Image.h"
+#include "Model.h"
+
+/**
+ * @class FrameClassifier
+ * @brief Классификация лиц кадра видео: детекция, оценка качества и предсказание пригодных лиц.
+ * Общая для режима видео emotion_detector и пакетной обработки emotion_batch, поэтому
+ * статистика по секундам видео в обоих случаях строится одинаково.
+ */
+class FrameClassifier {
+
+public:
+    /**
+     * @brief Предсказание для подготовленных ROI изображения (Model::classify или InferenceEngine::predict).
+     */
+    using Predictor = std::function<std::vector<EmotionPrediction>(Image&)>;
+
+    /**
+     * @brief Конструктор класса FrameClassifier.
+     * @param face_detector Детектор лиц; должен существовать дольше объекта.
+     * @param predictor Предсказание для ROI.
+     * @param quality_gate Не передавать в модель непригодные лица.
+     */
+    FrameClassifier(FaceDetector& face_detector, Predictor predictor, bool quality_gate);
+
+    /**
+     * @brief Находит лица кадра и классифицирует пригодные.
+     * @param frame Кадр.
+     * @return ID класса первого классифицированного лица или -1, если таких лиц нет.
+     */
+    int classify(const cv::Mat& frame);
+
+    /**
+     * @brief Получает рамки классифицированных лиц последнего кадра.
+     * @return Рамки в порядке предсказаний.
+     */
+    const std::vector<cv::Rect>& faces() const;
+
+    /**
+     * @brief Получает предсказания последнего кадра.
+     * @return Предсказания в порядке рамок faces.
+     */
+    const std::vector<EmotionPrediction>& predictions() const;
+
+    /**
+     * @brief Получает оценки качества всех найденных лиц последнего кадра.
+     * @return Оценки в порядке рамок детектора.
+     */
+    const std::vector<FaceQuality::Score>& scores() const;
+
+    /**
+     * @brief Выделяет ROI найденных лиц; при включённой оценке качества - только пригодных.
+     * @param face_detector Детектор лиц после detectFace.
+     * @param frame Исходный кадр.
+     * @param quality_gate Не передавать в модель непригодные лица.
+     * @param quality Оценка качества лиц.
+     * @param scores Оценки всех найденных лиц в порядке рамок (без оценки качества все пригодны).
+     * @return Изображение с ROI для модели.
+     */
+    static Image extractFaces(const FaceDetector& face_detector, const cv::Mat& frame, bool quality_gate,
+                              const FaceQuality& quality, std::vector<FaceQuality::Score>& scores);
+
+    /**
+     * @brief Считает секунды видео, которые получают класс последнего обработанного кадра:
+     * одна запись на секунду, пропущенные кадры наследуют последнее предсказание.
+     * @param time Позиция обработанного кадра, с.
+     * @param next_record Следующая секунда видео без записи; сдвигается за time.
+     * @return Количество новых записей.
+     */
+    static size_t recordSeconds(double time, double& next_record);
+
+private:
+    FaceDetector& face_detector; ///< Детектор лиц.
+    Predictor predictor; ///< Предсказание для ROI.
+    bool quality_gate; ///< Не передавать в модель непригодные лица.
+    FaceQuality quality; ///< Оценка качества лиц.
+    std::vector<cv::Rect> last_faces; ///< Рамки классифицированных лиц последнего кадра.
+    std::vector<EmotionPrediction> last_predictions; ///< Предсказания последнего кадра.
+    std::vector<FaceQuality::Score> last_scores; ///< Оценки всех лиц последнего кадра.
+};
+
+#endif
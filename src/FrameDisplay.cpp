@@ -0,0 +1,48 @@
+/**
+ * @file FrameDisplay.cpp
+ * @brief Реализация методов класса FrameDisplay.
+ */
+
+#include <opencv2/highgui.hpp>
+#include <iostream>
+#include "FrameDisplay.h"
+
+/**
+ * @brief Конструктор класса FrameDisplay.
+ * @param window_name Название окна.
+ */
+FrameDisplay::FrameDisplay(const std::string& window_name) : window_name(window_name) {}
+
+/**
+ * @brief Публикует обработанный кадр для отображения.
+ * @param packet Кадр и результаты его обработки.
+ */
+void FrameDisplay::publish(DisplayPacket packet) {
+    latest.write(std::move(packet));
+}
+
+/**
+ * @brief Цикл отображения последнего опубликованного кадра.
+ * @param stop Флаг остановки.
+ */
+void FrameDisplay::run(std::atomic<bool>& stop) {
+    // Создание окна с названием приложения
+    cv::namedWindow(window_name);
+
+    DisplayPacket packet;
+
+    while (!stop.load()) {
+        // Отрисовка только если поток обработки опубликовал новый кадр
+        if (latest.read(packet) && !packet.frame.empty()) {
+            cv::imshow(window_name, renderer.render(packet.frame.mat(), packet.faces, packet.emotion_prediction));
+        }
+
+        // Обработка событий окна. Если нажата клавиша 'Esc', выход из программы
+        if (cv::waitKey(5) == 27) {
+            std::cout << "Esc key is pressed by user. Stopping the program" << std::endl;
+            stop = true;
+        }
+    }
+
+    cv::destroyWindow(window_name);
+}
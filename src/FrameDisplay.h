@@ -0,0 +1,61 @@
+/**
+ * @file FrameDisplay.h
+ * @brief Объявление класса FrameDisplay.
+ */
+
+#ifndef FRAMEDISPLAY_H
+#define FRAMEDISPLAY_H
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "FramePool.h"
+#include "FrameRenderer.h"
+#include "TripleBuffer.h"
+
+/**
+ * @struct DisplayPacket
+ * @brief Кадр и результаты его обработки, передаваемые в поток отображения.
+ */
+struct DisplayPacket {
+    FramePool::Frame frame; ///< Исходный кадр без рамок из пула захвата.
+    std::vector<cv::Rect> faces; ///< Рамки вокруг лиц.
+    std::vector<std::string> emotion_prediction; ///< Предсказанные эмоции для каждой рамки.
+};
+
+/**
+ * @class FrameDisplay
+ * @brief Класс отображает последний обработанный кадр независимо от скорости обработки.
+ * Поток обработки публикует кадры через тройной буфер и никогда не ждёт отрисовки,
+ * а поток отображения рисует рамки и подписи предсказаний и обрабатывает события окна.
+ */
+class FrameDisplay {
+
+public:
+    /**
+     * @brief Конструктор класса FrameDisplay.
+     * @param window_name Название окна.
+     */
+    explicit FrameDisplay(const std::string& window_name);
+
+    /**
+     * @brief Публикует обработанный кадр для отображения (вызывается из потока обработки).
+     * @param packet Кадр и результаты его обработки.
+     */
+    void publish(DisplayPacket packet);
+
+    /**
+     * @brief Цикл отображения. Выполняется в потоке GUI (на macOS это должен быть главный поток),
+     * пока не будет выставлен флаг остановки или пользователь не нажмёт 'Esc'.
+     * @param stop Флаг остановки, выставляется при нажатии 'Esc'.
+     */
+    void run(std::atomic<bool>& stop);
+
+private:
+    std::string window_name; ///< Название окна.
+    TripleBuffer<DisplayPacket> latest; ///< Последний опубликованный кадр.
+    FrameRenderer renderer; ///< Отрисовка рамок и текста предсказаний.
+};
+
+#endif
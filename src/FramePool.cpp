@@ -0,0 +1,188 @@
+/**
+ * @file FramePool.cpp
+ * @brief Реализация методов класса FramePool.
+ */
+
+#include "FramePool.h"
+
+/**
+ * @brief Конструктор ссылки на кадр из пула.
+ * @param pool Пул, которому принадлежит кадр.
+ * @param index Индекс кадра в пуле.
+ */
+FramePool::Frame::Frame(FramePool* pool, size_t index) : pool(pool), index(index) {}
+
+/**
+ * @brief Копирование ссылки увеличивает счётчик ссылок на кадр.
+ * @param other Копируемая ссылка.
+ */
+FramePool::Frame::Frame(const Frame& other) : pool(other.pool), index(other.index) {
+    if (pool) {
+        pool->retain(index);
+    }
+}
+
+/**
+ * @brief Перемещение ссылки не изменяет счётчик ссылок.
+ * @param other Перемещаемая ссылка.
+ */
+FramePool::Frame::Frame(Frame&& other) noexcept : pool(other.pool), index(other.index) {
+    other.pool = nullptr;
+}
+
+/**
+ * @brief Копирующее присваивание освобождает текущий кадр и ссылается на кадр other.
+ * @param other Копируемая ссылка.
+ * @return Ссылка на текущий объект.
+ */
+FramePool::Frame& FramePool::Frame::operator=(const Frame& other) {
+    if (this != &other) {
+        if (other.pool) {
+            other.pool->retain(other.index);
+        }
+        release();
+        pool = other.pool;
+        index = other.index;
+    }
+    return *this;
+}
+
+/**
+ * @brief Перемещающее присваивание освобождает текущий кадр и забирает ссылку other.
+ * @param other Перемещаемая ссылка.
+ * @return Ссылка на текущий объект.
+ */
+FramePool::Frame& FramePool::Frame::operator=(Frame&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        index = other.index;
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+/**
+ * @brief Деструктор освобождает ссылку на кадр.
+ */
+FramePool::Frame::~Frame() {
+    release();
+}
+
+/**
+ * @brief Получает буфер кадра.
+ * @return Буфер кадра.
+ */
+cv::Mat& FramePool::Frame::mat() const {
+    return pool->slots[index].mat;
+}
+
+/**
+ * @brief Проверяет, ссылается ли объект на кадр из пула.
+ * @return true, если ссылка пустая.
+ */
+bool FramePool::Frame::empty() const {
+    return pool == nullptr;
+}
+
+/**
+ * @brief Освобождает ссылку на кадр.
+ */
+void FramePool::Frame::release() {
+    if (pool) {
+        pool->release(index);
+        pool = nullptr;
+    }
+}
+
+/**
+ * @brief Конструктор класса FramePool.
+ * @param capacity Количество кадров в пуле.
+ * @param size Размер кадра.
+ * @param type Тип кадра OpenCV.
+ */
+FramePool::FramePool(size_t capacity, cv::Size size, int type) : slots(capacity > 0 ? capacity : 1) {
+    free_slots.reserve(slots.size());
+
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (size.area() > 0) {
+            slots[i].mat.create(size, type);
+        }
+        free_slots.push_back(i);
+    }
+}
+
+/**
+ * @brief Получает свободный кадр, ожидая освобождения, если пул исчерпан.
+ * @return Ссылка на кадр.
+ */
+FramePool::Frame FramePool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    slot_released.wait(lock, [this]() { return !free_slots.empty(); });
+    return take();
+}
+
+/**
+ * @brief Получает свободный кадр, ожидая не дольше заданного времени.
+ * @param frame Ссылка, в которую будет записан кадр.
+ * @param timeout Максимальное время ожидания.
+ * @return true, если кадр получен.
+ */
+bool FramePool::tryAcquire(Frame& frame, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!slot_released.wait_for(lock, timeout, [this]() { return !free_slots.empty(); })) {
+        return false;
+    }
+    frame = take();
+    return true;
+}
+
+/**
+ * @brief Получает количество кадров в пуле.
+ * @return Количество кадров.
+ */
+size_t FramePool::capacity() const {
+    return slots.size();
+}
+
+/**
+ * @brief Получает количество свободных кадров.
+ * @return Количество свободных кадров.
+ */
+size_t FramePool::available() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return free_slots.size();
+}
+
+/**
+ * @brief Забирает кадр из списка свободных (мьютекс должен быть захвачен).
+ * @return Ссылка на кадр.
+ */
+FramePool::Frame FramePool::take() {
+    size_t index = free_slots.back();
+    free_slots.pop_back();
+    slots[index].refcount.store(1);
+    return Frame(this, index);
+}
+
+/**
+ * @brief Увеличивает счётчик ссылок на кадр.
+ * @param index Индекс кадра.
+ */
+void FramePool::retain(size_t index) {
+    slots[index].refcount.fetch_add(1);
+}
+
+/**
+ * @brief Уменьшает счётчик ссылок и возвращает кадр в пул после освобождения последней ссылки.
+ * @param index Индекс кадра.
+ */
+void FramePool::release(size_t index) {
+    if (slots[index].refcount.fetch_sub(1) == 1) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            free_slots.push_back(index);
+        }
+        slot_released.notify_one();
+    }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file FramePool.h
+ * @brief Объявление класса FramePool.
+ */
+
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class FramePool
+ * @brief Пул заранее выделенных кадров фиксированного размера для захвата видео.
+ * Кадры выдаются через счётчик ссылок и возвращаются в пул, когда все этапы
+ * конвейера (обработка, отображение) освободили их. Если свободных кадров нет,
+ * захват ждёт освобождения, что ограничивает очередь кадров (backpressure).
+ * Пул должен существовать дольше всех выданных кадров.
+ */
+class FramePool {
+
+public:
+    /**
+     * @class Frame
+     * @brief Ссылка на кадр из пула. Копирование увеличивает счётчик ссылок,
+     * при уничтожении последней ссылки кадр возвращается в пул.
+     */
+    class Frame {
+
+    public:
+        /**
+         * @brief Конструктор пустой ссылки.
+         */
+        Frame() {};
+
+        Frame(const Frame& other);
+        Frame(Frame&& other) noexcept;
+        Frame& operator=(const Frame& other);
+        Frame& operator=(Frame&& other) noexcept;
+
+        /**
+         * @brief Деструктор освобождает ссылку на кадр.
+         */
+        ~Frame();
+
+        /**
+         * @brief Получает буфер кадра. Память переиспользуется между кадрами.
+         * @return Буфер кадра.
+         */
+        cv::Mat& mat() const;
+
+        /**
+         * @brief Проверяет, ссылается ли объект на кадр из пула.
+         * @return true, если ссылка пустая.
+         */
+        bool empty() const;
+
+        /**
+         * @brief Освобождает ссылку на кадр досрочно.
+         */
+        void release();
+
+    private:
+        friend class FramePool;
+
+        Frame(FramePool* pool, size_t index);
+
+        FramePool* pool = nullptr; ///< Пул, которому принадлежит кадр.
+        size_t index = 0; ///< Индекс кадра в пуле.
+    };
+
+    /**
+     * @brief Конструктор выделяет все кадры пула заранее.
+     * @param capacity Количество кадров в пуле.
+     * @param size Размер кадра. Если не задан, память выделяется при первом захвате.
+     * @param type Тип кадра OpenCV.
+     */
+    FramePool(size_t capacity, cv::Size size = cv::Size(), int type = CV_8UC3);
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    /**
+     * @brief Получает свободный кадр, ожидая освобождения, если пул исчерпан.
+     * @return Ссылка на кадр.
+     */
+    Frame acquire();
+
+    /**
+     * @brief Получает свободный кадр, ожидая не дольше заданного времени.
+     * @param frame Ссылка, в которую будет записан кадр.
+     * @param timeout Максимальное время ожидания.
+     * @return true, если кадр получен.
+     */
+    bool tryAcquire(Frame& frame, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Получает количество кадров в пуле.
+     * @return Количество кадров.
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Получает количество свободных кадров.
+     * @return Количество свободных кадров.
+     */
+    size_t available();
+
+private:
+    /**
+     * @struct Slot
+     * @brief Кадр пула и счётчик ссылок на него.
+     */
+    struct Slot {
+        cv::Mat mat; ///< Буфер кадра.
+        std::atomic<int> refcount{0}; ///< Количество ссылок на кадр.
+    };
+
+    void retain(size_t index);
+    void release(size_t index);
+    Frame take();
+
+    std::vector<Slot> slots; ///< Все кадры пула.
+    std::vector<size_t> free_slots; ///< Индексы свободных кадров.
+    std::mutex mutex; ///< Защита списка свободных кадров.
+    std::condition_variable slot_released; ///< Сигнал об освобождении кадра.
+};
+
+#endif
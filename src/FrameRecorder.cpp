@@ -0,0 +1,158 @@
+/**
+ * @file FrameRecorder.cpp
+ * @brief Реализация методов класса FrameRecorder.
+ */
+
+#include <opencv2/imgcodecs.hpp>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "FrameRecorder.h"
+
+/**
+ * @brief Наибольшее количество кадров в очереди записи.
+ */
+static const size_t MAX_PENDING_FRAMES = 32;
+
+/**
+ * @brief Проверяет, можно ли сжать кадр в PNG без потерь.
+ * @param frame Кадр.
+ * @return true для 8- и 16-битных кадров с 1, 3 или 4 каналами.
+ */
+static bool pngSupports(const cv::Mat& frame) {
+    int channels = frame.channels();
+    return (frame.depth() == CV_8U || frame.depth() == CV_16U) && (channels == 1 || channels == 3 || channels == 4);
+}
+
+/**
+ * @brief Конструктор создаёт файл записи и записывает заголовок.
+ * @param filename Путь к файлу.
+ * @param codec Кодирование кадров.
+ */
+FrameRecorder::FrameRecorder(const std::string& filename, RecordingCodec codec) : codec(codec) {
+    file = std::fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "Unable to create recording " << filename << std::endl;
+        return;
+    }
+
+    RecordingHeader header = {};
+    std::memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+    header.version = RECORDING_VERSION;
+    header.codec = codec;
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        failed = true;
+    }
+    writer.reset(new ThreadPool(1));
+}
+
+/**
+ * @brief Деструктор дописывает очередь и закрывает файл.
+ */
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+/**
+ * @brief Проверяет, открыт ли файл и не было ли ошибок записи.
+ * @return true, если кадры записываются.
+ */
+bool FrameRecorder::isOpen() const {
+    return file != nullptr && !failed;
+}
+
+/**
+ * @brief Ставит копию кадра в очередь записи.
+ * @param frame Кадр.
+ * @param timestamp Время кадра, с.
+ * @return false, если файл закрыт или запись завершилась ошибкой.
+ */
+bool FrameRecorder::write(const cv::Mat& frame, double timestamp) {
+    if (!isOpen() || frame.empty()) {
+        return false;
+    }
+
+    // Записанные кадры убираются из очереди; при переполнении ждём самый старый
+    while (!pending.empty() && (pending.size() >= MAX_PENDING_FRAMES ||
+           pending.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+        pending.front().get();
+        pending.pop_front();
+    }
+
+    // Кадр источника может быть заголовком поверх чужой памяти, поэтому копируется сразу
+    cv::Mat copy = frame.clone();
+    pending.push_back(writer->submit([this, copy, timestamp]() {
+        writeFrame(copy, timestamp);
+    }));
+    return true;
+}
+
+/**
+ * @brief Записывает кадр в файл (выполняется в потоке записи).
+ * @param frame Непрерывная копия кадра.
+ * @param timestamp Время кадра, с.
+ */
+void FrameRecorder::writeFrame(const cv::Mat& frame, double timestamp) {
+    if (failed) {
+        return;
+    }
+
+    RecordedFrameHeader header = {};
+    header.timestamp = timestamp;
+    header.rows = frame.rows;
+    header.cols = frame.cols;
+    header.type = frame.type();
+
+    const uchar* data = frame.data;
+    std::vector<uchar> encoded;
+    if (codec == RECORDING_PNG && pngSupports(frame)) {
+        // Наименьшая степень сжатия: PNG без потерь, а кодирование успевает за камерой
+        cv::imencode(".png", frame, encoded, {cv::IMWRITE_PNG_COMPRESSION, 1});
+        header.codec = RECORDING_PNG;
+        header.size = encoded.size();
+        data = encoded.data();
+    } else {
+        header.codec = RECORDING_RAW;
+        header.size = frame.total() * frame.elemSize();
+    }
+
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+        std::fwrite(data, 1, header.size, file) != header.size) {
+        failed = true;
+        return;
+    }
+    frames++;
+}
+
+/**
+ * @brief Дописывает очередь, записывает количество кадров в заголовок и закрывает файл.
+ * @return true, если все кадры записаны.
+ */
+bool FrameRecorder::close() {
+    if (file == nullptr) {
+        return false;
+    }
+
+    for (std::future<void>& frame : pending) {
+        frame.get();
+    }
+    pending.clear();
+    writer.reset();
+
+    // Количество кадров в заголовке отличает закрытую запись от оборванной
+    uint64_t frame_count = frames;
+    bool written = !failed && std::fseek(file, offsetof(RecordingHeader, frame_count), SEEK_SET) == 0 &&
+                   std::fwrite(&frame_count, sizeof(frame_count), 1, file) == 1;
+    written = std::fclose(file) == 0 && written;
+    file = nullptr;
+    return written;
+}
+
+/**
+ * @brief Получает количество записанных кадров.
+ * @return Количество кадров.
+ */
+uint64_t FrameRecorder::frameCount() const {
+    return frames;
+}
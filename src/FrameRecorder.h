@@ -0,0 +1,125 @@
+/**
+ * @file FrameRecorder.h
+ * @brief Объявление класса FrameRecorder и формата записи кадров.
+ */
+
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include "ThreadPool.h"
+
+/**
+ * @brief Сигнатура файла записи кадров.
+ */
+static const char RECORDING_MAGIC[8] = {'E', 'M', 'O', 'R', 'E', 'C', '\0', '\0'};
+
+/**
+ * @brief Версия формата записи кадров.
+ */
+static const uint32_t RECORDING_VERSION = 1;
+
+/**
+ * @enum RecordingCodec
+ * @brief Кодирование пикселей кадра в записи.
+ */
+enum RecordingCodec : uint32_t {
+    RECORDING_RAW = 0, ///< Пиксели без сжатия: воспроизведение без декодирования.
+    RECORDING_PNG = 1 ///< Сжатие без потерь PNG; кадры, которые PNG не поддерживает, пишутся без сжатия.
+};
+
+/**
+ * @struct RecordingHeader
+ * @brief Заголовок файла записи (порядок байтов хоста).
+ */
+struct RecordingHeader {
+    char magic[8]; ///< RECORDING_MAGIC.
+    uint32_t version; ///< RECORDING_VERSION.
+    uint32_t codec; ///< Кодирование по умолчанию (RecordingCodec).
+    uint64_t frame_count; ///< Количество кадров; 0, если запись не была закрыта.
+};
+
+/**
+ * @struct RecordedFrameHeader
+ * @brief Заголовок кадра в записи; за ним следуют size байт данных.
+ */
+struct RecordedFrameHeader {
+    double timestamp; ///< Время кадра, полученное от источника, с.
+    int32_t rows; ///< Высота кадра.
+    int32_t cols; ///< Ширина кадра.
+    int32_t type; ///< Тип кадра OpenCV.
+    uint32_t codec; ///< Кодирование данных кадра (RecordingCodec).
+    uint64_t size; ///< Размер данных кадра, байт.
+};
+
+/**
+ * @class FrameRecorder
+ * @brief Запись несжатых кадров источника и их времени в файл для воспроизведения через ReplaySource.
+ * Кадры копируются и пишутся в отдельном потоке в порядке поступления, поэтому запись
+ * почти не задерживает конвейер. Очередь ограничена: если диск не успевает, write ждёт,
+ * но не теряет кадры - запись должна точно повторять поток.
+ */
+class FrameRecorder {
+
+public:
+    /**
+     * @brief Конструктор создаёт файл записи.
+     * @param filename Путь к файлу.
+     * @param codec Кодирование кадров.
+     */
+    explicit FrameRecorder(const std::string& filename, RecordingCodec codec = RECORDING_RAW);
+
+    /**
+     * @brief Деструктор дописывает очередь и закрывает файл.
+     */
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    /**
+     * @brief Проверяет, открыт ли файл и не было ли ошибок записи.
+     * @return true, если кадры записываются.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Ставит копию кадра в очередь записи.
+     * @param frame Кадр любого типа.
+     * @param timestamp Время кадра, с.
+     * @return false, если файл закрыт или запись завершилась ошибкой.
+     */
+    bool write(const cv::Mat& frame, double timestamp);
+
+    /**
+     * @brief Дописывает очередь, записывает количество кадров в заголовок и закрывает файл.
+     * @return true, если все кадры записаны.
+     */
+    bool close();
+
+    /**
+     * @brief Получает количество записанных кадров. Кадры из очереди записи учитываются
+     * только после записи, поэтому итоговое значение нужно читать после close.
+     * @return Количество кадров.
+     */
+    uint64_t frameCount() const;
+
+private:
+    void writeFrame(const cv::Mat& frame, double timestamp);
+
+    FILE* file = nullptr; ///< Файл записи; используется только потоком записи.
+    RecordingCodec codec; ///< Кодирование кадров.
+    std::unique_ptr<ThreadPool> writer; ///< Поток записи: задачи выполняются по порядку.
+    std::deque<std::future<void>> pending; ///< Кадры в очереди записи.
+    std::atomic<uint64_t> frames{0}; ///< Количество записанных кадров.
+    std::atomic<bool> failed{false}; ///< Признак ошибки записи.
+};
+
+#endif
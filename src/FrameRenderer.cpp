@@ -0,0 +1,71 @@
+/**
+ * @file FrameRenderer.cpp
+ * @brief Реализация методов класса FrameRenderer.
+ */
+
+#include <opencv2/imgproc.hpp>
+#include "FrameRenderer.h"
+
+/**
+ * @brief Конструктор класса FrameRenderer.
+ * @param pool_size Количество выходных буферов.
+ */
+FrameRenderer::FrameRenderer(size_t pool_size) : pool(pool_size > 0 ? pool_size : 1) {}
+
+/**
+ * @brief Включает или отключает отрисовку.
+ * @param enabled true, если нужно рисовать рамки и текст.
+ */
+void FrameRenderer::setEnabled(bool enabled) {
+    this->enabled = enabled;
+}
+
+/**
+ * @brief Проверяет, включена ли отрисовка.
+ * @return true, если отрисовка включена.
+ */
+bool FrameRenderer::isEnabled() const {
+    return enabled;
+}
+
+/**
+ * @brief Рисует рамки вокруг лиц и текст предсказаний в буфер из пула.
+ * @param frame Исходный кадр.
+ * @param faces Рамки вокруг лиц.
+ * @param emotion_prediction Вектор строк с предсказанными эмоциями.
+ * @return Кадр с рамками и текстом.
+ */
+cv::Mat FrameRenderer::render(const cv::Mat& frame, const std::vector<cv::Rect>& faces, const std::vector<std::string>& emotion_prediction) {
+    if (!enabled || frame.empty()) {
+        return frame;
+    }
+
+    // Копирование кадра в следующий буфер пула (память переиспользуется при неизменном размере)
+    cv::Mat& output = pool[next];
+    next = (next + 1) % pool.size();
+    frame.copyTo(output);
+
+    for (int i = 0; i < faces.size(); i++) {
+        cv::Rect r = faces[i];
+
+        // Рисование прямоугольника вокруг лица
+        cv::rectangle(output,
+                      cv::Point(r.x, r.y),
+                      cv::Point(r.x + r.width, r.y + r.height),
+                      cv::Scalar(255, 0, 0), 3, 8, 0);
+
+        // Подписей может быть меньше, чем рамок (часть лиц ещё без предсказания)
+        if (i < emotion_prediction.size() && !emotion_prediction[i].empty()) {
+            // Написание текста с предсказанием на рамке
+            cv::putText(output, // целевое изображение
+                        emotion_prediction[i], // текст - результат работы модели
+                        cv::Point(r.x, r.y - 10), // верхняя левая позиция рамки
+                        cv::FONT_HERSHEY_DUPLEX,
+                        1.0,
+                        CV_RGB(118, 185, 0), // цвет шрифта
+                        2);
+        }
+    }
+
+    return output;
+}
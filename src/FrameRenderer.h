@@ -0,0 +1,57 @@
+/**
+ * @file FrameRenderer.h
+ * @brief Объявление класса FrameRenderer.
+ */
+
+#ifndef FRAMERENDERER_H
+#define FRAMERENDERER_H
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @class FrameRenderer
+ * @brief Класс рисует рамки вокруг лиц и текст предсказаний в копию кадра.
+ * Исходный кадр не изменяется, а выходные кадры берутся из небольшого пула
+ * переиспользуемых буферов, поэтому рендеринг не выделяет память на каждый кадр.
+ */
+class FrameRenderer {
+
+public:
+    /**
+     * @brief Конструктор класса FrameRenderer.
+     * @param pool_size Количество выходных буферов. Результат render остаётся
+     * действительным, пока не выполнено ещё pool_size вызовов render.
+     */
+    explicit FrameRenderer(size_t pool_size = 2);
+
+    /**
+     * @brief Включает или отключает отрисовку (например, в режиме без отображения).
+     * @param enabled true, если нужно рисовать рамки и текст.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Проверяет, включена ли отрисовка.
+     * @return true, если отрисовка включена.
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief Рисует рамки вокруг лиц и текст предсказаний.
+     * Если для лица нет предсказания (их меньше, чем рамок, или подпись пустая), рисуется только рамка.
+     * @param frame Исходный кадр, не изменяется.
+     * @param faces Рамки вокруг лиц.
+     * @param emotion_prediction Вектор строк с предсказанными эмоциями.
+     * @return Кадр с рамками и текстом из пула буферов или исходный кадр, если отрисовка отключена.
+     */
+    cv::Mat render(const cv::Mat& frame, const std::vector<cv::Rect>& faces, const std::vector<std::string>& emotion_prediction);
+
+private:
+    std::vector<cv::Mat> pool; ///< Пул выходных буферов.
+    size_t next = 0; ///< Индекс следующего выходного буфера.
+    bool enabled = true; ///< Признак включённой отрисовки.
+};
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file FrameSource.h
+ * @brief Объявление интерфейса FrameSource.
+ */
+
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <opencv2/core.hpp>
+
+/**
+ * @class FrameSource
+ * @brief Источник кадров для потоковой обработки (камера, разделяемая память и т.д.).
+ * Повторяет часть интерфейса cv::VideoCapture, поэтому конвейер не зависит от того,
+ * откуда приходят кадры.
+ */
+class FrameSource {
+
+public:
+    /**
+     * @brief Виртуальный деструктор.
+     */
+    virtual ~FrameSource() {};
+
+    /**
+     * @brief Проверяет, открыт ли источник.
+     * @return true, если из источника можно читать кадры.
+     */
+    virtual bool isOpened() const = 0;
+
+    /**
+     * @brief Считывает следующий кадр, ожидая его появления.
+     * Источник может вернуть кадр без копирования (заголовок поверх своей памяти),
+     * поэтому содержимое frame действительно только до следующего вызова read.
+     * @param frame Кадр.
+     * @return false, если кадров больше нет или источник отключился.
+     */
+    virtual bool read(cv::Mat& frame) = 0;
+
+    /**
+     * @brief Получает время последнего считанного кадра.
+     * @return Время в секундах от начала потока.
+     */
+    virtual double timestamp() const = 0;
+
+    /**
+     * @brief Проверяет, что память последнего считанного кадра не перезаписана источником.
+     * Имеет смысл для источников, отдающих кадр без копирования; остальные всегда возвращают true.
+     * @return true, если данные последнего кадра всё ещё целы.
+     */
+    virtual bool lastFrameValid() const { return true; };
+
+    /**
+     * @brief Получает свойство источника (cv::CAP_PROP_*).
+     * @param property Идентификатор свойства.
+     * @return Значение свойства или 0, если оно не поддерживается.
+     */
+    virtual double get(int property) const { return 0.0; };
+
+    /**
+     * @brief Устанавливает свойство источника (cv::CAP_PROP_*).
+     * @param property Идентификатор свойства.
+     * @param value Значение.
+     * @return true, если свойство поддерживается.
+     */
+    virtual bool set(int property, double value) { return false; };
+};
+
+#endif
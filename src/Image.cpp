@@ -3,7 +3,7 @@
  * @brief Реализация методов класса Image.
  */
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/imgproc.hpp>
 #include "Image.h"
 
 /**
@@ -55,9 +55,9 @@ void Image::preprocessROI() {
 
     if (_roi_image.size() > 0) {
         for (int i = 0; i < _roi_image.size(); i++) {
-            // Конвертация в градации серого
+            // Конвертация в градации серого, если ROI не вырезаны из плоскости яркости
             cv::Mat gray_image;
-            cv::cvtColor(_roi_image[i], gray_image, cv::COLOR_BGR2GRAY);
+            toGray(_roi_image[i], gray_image);
 
             // Изменение размера ROI до входного размера модели
             cv::resize(gray_image, processed_image, cv::Size(48, 48));
@@ -69,4 +69,27 @@ void Image::preprocessROI() {
             _model_input_image.push_back(processed_image);
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Получает изображение в градациях серого из кадра любого поддерживаемого формата.
+ * @param frame Исходный кадр.
+ * @param gray Изображение в градациях серого.
+ */
+void Image::toGray(const cv::Mat& frame, cv::Mat& gray) {
+    switch (frame.channels()) {
+    case 1:
+        gray = frame;
+        break;
+    case 2:
+        // YUYV: яркость Y в нулевом канале каждого пикселя
+        cv::extractChannel(frame, gray, 0);
+        break;
+    case 4:
+        cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
+        break;
+    default:
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        break;
+    }
+}
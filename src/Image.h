@@ -6,7 +6,7 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
 #include <iostream>
 
 /**
@@ -52,10 +52,20 @@ public:
 
     /**
      * @brief Предобрабатывает области интереса (ROI) для входа модели.
-     * Конвертирует изображения в градации серого, изменяет их размер и нормализует пиксели.
+     * Конвертирует изображения в градации серого (если ROI ещё цветные), изменяет их размер и нормализует пиксели.
      */
     void preprocessROI();
 
+    /**
+     * @brief Получает изображение в градациях серого из кадра любого поддерживаемого формата.
+     * Одноканальный кадр используется без копирования, из двухканального (YUYV, захват без
+     * конвертации в RGB) берётся плоскость яркости, BGR и BGRA конвертируются.
+     * @param frame Исходный кадр.
+     * @param gray Изображение в градациях серого; память переиспользуется при неизменном размере.
+     * Для одноканального кадра gray становится ссылкой на данные frame.
+     */
+    static void toGray(const cv::Mat& frame, cv::Mat& gray);
+
     /**
      * @brief Получает вектор изображений для входа модели.
      * @return Вектор изображений для входа модели.
@@ -0,0 +1,180 @@
+/**
+ * @file InferenceBatcher.cpp
+ * @brief Реализация методов класса InferenceBatcher.
+ */
+
+#include <algorithm>
+#include "InferenceBatcher.h"
+
+/**
+ * @brief Конструктор с параметрами по умолчанию.
+ * @param engine Движок предсказаний.
+ */
+InferenceBatcher::InferenceBatcher(InferenceEngine& engine) : InferenceBatcher(engine, Settings()) {}
+
+/**
+ * @brief Конструктор запускает рабочие потоки.
+ * @param engine Движок предсказаний.
+ * @param settings Параметры объединения в пачки.
+ */
+InferenceBatcher::InferenceBatcher(InferenceEngine& engine, const Settings& settings)
+    : engine(engine), settings(settings) {
+    this->settings.max_batch = std::max<size_t>(1, settings.max_batch);
+    size_t worker_count = std::max<size_t>(1, settings.workers);
+    for (size_t i = 0; i < worker_count; i++) {
+        workers.emplace_back(&InferenceBatcher::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Деструктор выполняет оставшиеся в очереди входы и останавливает потоки.
+ */
+InferenceBatcher::~InferenceBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    request_added.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Ставит вход в очередь.
+ * @param input Подготовленный вход модели.
+ * @return Future с результатом.
+ */
+std::future<EmotionPrediction> InferenceBatcher::submit(const cv::Mat& input) {
+    Request request;
+    request.input = input;
+    request.arrival = std::chrono::steady_clock::now();
+    std::future<EmotionPrediction> result = request.result.get_future();
+
+    size_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(request));
+        queued = queue.size();
+    }
+
+    // Рабочий поток ждёт либо первого входа, либо полной пачки
+    if (queued == 1 || queued >= settings.max_batch) {
+        request_added.notify_one();
+    }
+    return result;
+}
+
+/**
+ * @brief Ставит все входы в очередь и дожидается результатов.
+ * @param inputs Подготовленные входы модели.
+ * @return Результаты в порядке входов.
+ */
+std::vector<EmotionPrediction> InferenceBatcher::predict(const std::vector<cv::Mat>& inputs) {
+    std::vector<std::future<EmotionPrediction>> futures;
+    futures.reserve(inputs.size());
+    for (const cv::Mat& input : inputs) {
+        futures.push_back(submit(input));
+    }
+
+    std::vector<EmotionPrediction> predictions;
+    predictions.reserve(futures.size());
+    for (std::future<EmotionPrediction>& future : futures) {
+        predictions.push_back(future.get());
+    }
+    return predictions;
+}
+
+/**
+ * @brief Получает количество выполненных пачек.
+ * @return Количество пачек.
+ */
+size_t InferenceBatcher::batchCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return batches;
+}
+
+/**
+ * @brief Получает средний размер выполненной пачки.
+ * @return Средний размер пачки.
+ */
+double InferenceBatcher::meanBatchSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return batches > 0 ? static_cast<double>(batched_inputs) / batches : 0.0;
+}
+
+/**
+ * @brief Получает статистику времени ожидания входов в очереди.
+ * @return Статистика задержек.
+ */
+const LatencyStats& InferenceBatcher::queueStats() const {
+    return queue_stats;
+}
+
+/**
+ * @brief Цикл рабочего потока: набирает пачку до заполнения или истечения срока и выполняет её.
+ */
+void InferenceBatcher::workerLoop() {
+    const auto max_delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(settings.max_delay_ms));
+
+    while (true) {
+        std::vector<Request> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            request_added.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+
+            // Срок отсчитывается от самого старого входа, поэтому задержка ограничена max_delay_ms
+            auto deadline = queue.front().arrival + max_delay;
+            request_added.wait_until(lock, deadline, [this]() {
+                return stopping || queue.empty() || queue.size() >= settings.max_batch;
+            });
+            if (queue.empty()) {
+                continue; // пачку забрал другой рабочий поток
+            }
+
+            size_t batch_size = std::min(queue.size(), settings.max_batch);
+            batch.reserve(batch_size);
+            for (size_t i = 0; i < batch_size; i++) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            batches++;
+            batched_inputs += batch_size;
+        }
+
+        // Остаток очереди может забрать другой рабочий поток
+        request_added.notify_one();
+        runBatch(batch);
+    }
+}
+
+/**
+ * @brief Выполняет пачку одним прямым проходом и передаёт результаты вызывающим потокам.
+ * @param batch Пачка входов.
+ */
+void InferenceBatcher::runBatch(std::vector<Request>& batch) {
+    auto started = std::chrono::steady_clock::now();
+    std::vector<cv::Mat> inputs;
+    inputs.reserve(batch.size());
+    for (Request& request : batch) {
+        inputs.push_back(request.input);
+        queue_stats.record(std::chrono::duration<double, std::milli>(started - request.arrival).count());
+    }
+
+    try {
+        std::vector<EmotionPrediction> predictions = engine.predict(inputs);
+        for (size_t i = 0; i < batch.size(); i++) {
+            // Пустой результат, если сеть не загружена
+            batch[i].result.set_value(i < predictions.size() ? predictions[i] : EmotionPrediction());
+        }
+    } catch (...) {
+        for (Request& request : batch) {
+            request.result.set_exception(std::current_exception());
+        }
+    }
+}
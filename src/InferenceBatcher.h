@@ -0,0 +1,122 @@
+/**
+ * @file InferenceBatcher.h
+ * @brief Объявление класса InferenceBatcher.
+ */
+
+#ifndef INFERENCEBATCHER_H
+#define INFERENCEBATCHER_H
+
+#include <opencv2/core.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "InferenceEngine.h"
+#include "LatencyStats.h"
+
+/**
+ * @class InferenceBatcher
+ * @brief Динамическое объединение запросов в пачки с ограничением по времени ожидания.
+ * Входы из разных потоков попадают в общую очередь. Рабочий поток ждёт, пока наберётся
+ * полная пачка или истечёт срок ожидания самого старого входа, и выполняет один прямой
+ * проход InferenceEngine для всей пачки.
+ */
+class InferenceBatcher {
+
+public:
+    /**
+     * @struct Settings
+     * @brief Параметры объединения в пачки.
+     */
+    struct Settings {
+        size_t max_batch = 16; ///< Наибольший размер пачки.
+        double max_delay_ms = 2.0; ///< Наибольшее время ожидания входа в очереди до запуска пачки, мс.
+        size_t workers = 2; ///< Количество рабочих потоков (одна пачка выполняется, следующая набирается).
+    };
+
+    /**
+     * @brief Конструктор с параметрами по умолчанию.
+     * @param engine Движок предсказаний; должен существовать дольше объекта.
+     */
+    explicit InferenceBatcher(InferenceEngine& engine);
+
+    /**
+     * @brief Конструктор запускает рабочие потоки.
+     * @param engine Движок предсказаний; должен существовать дольше объекта.
+     * @param settings Параметры объединения в пачки.
+     */
+    InferenceBatcher(InferenceEngine& engine, const Settings& settings);
+
+    /**
+     * @brief Деструктор выполняет оставшиеся в очереди входы и останавливает потоки.
+     */
+    ~InferenceBatcher();
+
+    InferenceBatcher(const InferenceBatcher&) = delete;
+    InferenceBatcher& operator=(const InferenceBatcher&) = delete;
+
+    /**
+     * @brief Ставит вход в очередь.
+     * @param input Подготовленный вход модели (48x48, CV_32F).
+     * @return Future с результатом; ошибка движка передаётся через future.
+     */
+    std::future<EmotionPrediction> submit(const cv::Mat& input);
+
+    /**
+     * @brief Ставит все входы в очередь и дожидается результатов.
+     * @param inputs Подготовленные входы модели.
+     * @return Результаты в порядке входов.
+     */
+    std::vector<EmotionPrediction> predict(const std::vector<cv::Mat>& inputs);
+
+    /**
+     * @brief Получает количество выполненных пачек.
+     * @return Количество пачек.
+     */
+    size_t batchCount() const;
+
+    /**
+     * @brief Получает средний размер выполненной пачки.
+     * @return Средний размер пачки.
+     */
+    double meanBatchSize() const;
+
+    /**
+     * @brief Получает статистику времени ожидания входов в очереди.
+     * @return Статистика задержек.
+     */
+    const LatencyStats& queueStats() const;
+
+private:
+    /**
+     * @struct Request
+     * @brief Вход, ожидающий выполнения.
+     */
+    struct Request {
+        cv::Mat input; ///< Вход модели.
+        std::promise<EmotionPrediction> result; ///< Результат для вызывающего потока.
+        std::chrono::steady_clock::time_point arrival; ///< Время постановки в очередь.
+    };
+
+    void workerLoop();
+    void runBatch(std::vector<Request>& batch);
+
+    InferenceEngine& engine; ///< Движок предсказаний.
+    Settings settings; ///< Параметры объединения в пачки.
+
+    std::deque<Request> queue; ///< Очередь входов.
+    bool stopping = false; ///< Признак остановки.
+    mutable std::mutex mutex; ///< Мьютекс для очереди и счётчиков.
+    std::condition_variable request_added; ///< Сигнал о новом входе.
+
+    size_t batches = 0; ///< Количество выполненных пачек.
+    size_t batched_inputs = 0; ///< Количество входов в выполненных пачках.
+    LatencyStats queue_stats; ///< Время ожидания в очереди.
+
+    std::vector<std::thread> workers; ///< Рабочие потоки.
+};
+
+#endif
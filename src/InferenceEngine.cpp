@@ -0,0 +1,174 @@
+/**
+ * @file InferenceEngine.cpp
+ * @brief Реализация методов класса InferenceEngine.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "InferenceEngine.h"
+
+/**
+ * @brief Конструктор читает файл модели TensorFlow в память.
+ * @param model_filename Путь к файлу модели.
+ */
+InferenceEngine::InferenceEngine(const std::string& model_filename) {
+    std::ifstream file(model_filename, std::ios::binary);
+    if (!file) {
+        std::cerr << "Unable to open model " << model_filename << std::endl;
+        return;
+    }
+
+    // Файл читается один раз, сеть строится из этой копии при первом предсказании
+    model_storage.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    model_data = model_storage.data();
+    model_size = model_storage.size();
+}
+
+/**
+ * @brief Конструктор использует запись модели из пакета моделей.
+ * @param bundle Открытый пакет моделей.
+ */
+InferenceEngine::InferenceEngine(const ModelBundle& bundle) {
+    if (!bundle.find(ModelBundle::MODEL_ENTRY, model_data, model_size)) {
+        std::cerr << "Model bundle has no " << ModelBundle::MODEL_ENTRY << " entry" << std::endl;
+        model_data = nullptr;
+        model_size = 0;
+    }
+}
+
+/**
+ * @brief Проверяет, загружена ли модель.
+ * @return true, если сериализованной модели нет.
+ */
+bool InferenceEngine::empty() const {
+    return model_size == 0;
+}
+
+/**
+ * @brief Классифицирует пачку входов. Поток, заставший сеть свободной, выполняет прямой проход
+ * для всех ожидающих вызовов; остальные ждут, пока их входы не войдут в один из проходов.
+ * @param inputs Подготовленные входы модели.
+ * @return Результаты в порядке входов.
+ */
+std::vector<EmotionPrediction> InferenceEngine::predict(const std::vector<cv::Mat>& inputs) {
+    double forward_ms = 0.0;
+    return predict(inputs, forward_ms);
+}
+
+/**
+ * @brief Классифицирует пачку входов и сообщает время прямого прохода, в который они вошли.
+ * @param inputs Подготовленные входы модели.
+ * @param forward_ms Время прямого прохода в миллисекундах.
+ * @return Результаты в порядке входов.
+ */
+std::vector<EmotionPrediction> InferenceEngine::predict(const std::vector<cv::Mat>& inputs, double& forward_ms) {
+    forward_ms = 0.0;
+    if (inputs.empty() || empty()) {
+        return std::vector<EmotionPrediction>();
+    }
+
+    Request request;
+    request.inputs = &inputs;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    pending.push_back(&request);
+    while (!request.done) {
+        if (running) {
+            forward_finished.wait(lock);
+            continue;
+        }
+
+        // Сеть свободна: этот поток выполняет проход для всех накопившихся вызовов, включая свой
+        std::vector<Request*> batch;
+        batch.swap(pending);
+        running = true;
+        forwards++;
+        lock.unlock();
+        forward(batch);
+        lock.lock();
+        running = false;
+        for (Request* done : batch) {
+            done->done = true;
+        }
+        forward_finished.notify_all();
+    }
+    lock.unlock();
+
+    if (request.error) {
+        std::rethrow_exception(request.error);
+    }
+    forward_ms = request.forward_ms;
+    return std::move(request.predictions);
+}
+
+/**
+ * @brief Классифицирует лица изображения.
+ * @param image Изображение с подготовленными ROI.
+ * @return Вектор строк с предсказанными эмоциями и их вероятностями.
+ */
+std::vector<std::string> InferenceEngine::predict(Image& image) {
+    std::vector<std::string> emotion_prediction;
+    for (const EmotionPrediction& prediction : predict(image.getModelInput())) {
+        emotion_prediction.push_back(Model::formatPrediction(prediction));
+    }
+    return emotion_prediction;
+}
+
+/**
+ * @brief Получает количество выполненных прямых проходов.
+ * @return Количество прямых проходов.
+ */
+uint64_t InferenceEngine::forwardCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return forwards;
+}
+
+/**
+ * @brief Выполняет один прямой проход для входов нескольких вызовов и раздаёт результаты.
+ * Вызывается без блокировки, но только одним потоком одновременно.
+ * @param batch Вызовы, входы которых объединяются в пачку.
+ */
+void InferenceEngine::forward(const std::vector<Request*>& batch) {
+    try {
+        // Разбор модели долгий, поэтому выполняется при первом проходе, а не в конструкторе
+        if (!network_loaded) {
+            network_loaded = true;
+            try {
+                network = cv::dnn::readNetFromTensorflow(model_data, model_size);
+            } catch (const cv::Exception& e) {
+                std::cerr << "Unable to load network: " << e.what() << std::endl;
+            }
+        }
+        if (network.empty()) {
+            return;
+        }
+
+        // Входы всех вызовов собираются в буферы, их память переиспользуется между проходами
+        auto started = std::chrono::steady_clock::now();
+        inputs.clear();
+        for (const Request* request : batch) {
+            inputs.insert(inputs.end(), request->inputs->begin(), request->inputs->end());
+        }
+        cv::dnn::blobFromImages(inputs, blob);
+        network.setInput(blob);
+        network.forward(outputs);
+        double forward_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+        // Одна строка вероятностей на каждый вход, по порядку вызовов
+        cv::Mat prob = outputs[0].reshape(1, static_cast<int>(inputs.size()));
+        int row = 0;
+        for (Request* request : batch) {
+            request->forward_ms = forward_ms;
+            request->predictions.reserve(request->inputs->size());
+            for (size_t i = 0; i < request->inputs->size(); i++) {
+                request->predictions.push_back(Model::toPrediction(prob.row(row++)));
+            }
+        }
+    } catch (...) {
+        for (Request* request : batch) {
+            request->error = std::current_exception();
+        }
+    }
+}
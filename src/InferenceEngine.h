@@ -0,0 +1,117 @@
+/**
+ * @file InferenceEngine.h
+ * @brief Объявление класса InferenceEngine.
+ */
+
+#ifndef INFERENCEENGINE_H
+#define INFERENCEENGINE_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/dnn.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Image.h"
+#include "Model.h"
+#include "ModelBundle.h"
+
+/**
+ * @class InferenceEngine
+ * @brief Потокобезопасный фасад над сетью распознавания эмоций с одной копией весов.
+ * Модель разбирается в одну сеть cv::dnn::Net при первом предсказании. Потоки не получают
+ * собственных сетей: входы всех вызовов predict, пришедших, пока сеть занята, объединяются
+ * в следующий прямой проход, а OpenCV распределяет этот проход по ядрам процессора.
+ * Поэтому каждый вызывающий поток добавляет только память своих входов и результатов,
+ * а активации сети растут с размером объединённой пачки.
+ */
+class InferenceEngine {
+
+public:
+    /**
+     * @brief Конструктор читает файл модели TensorFlow в память.
+     * @param model_filename Путь к файлу модели (.pb).
+     */
+    explicit InferenceEngine(const std::string& model_filename);
+
+    /**
+     * @brief Конструктор использует запись модели из пакета моделей без копирования.
+     * Пакет должен оставаться открытым, пока существует объект.
+     * @param bundle Открытый пакет моделей с записью ModelBundle::MODEL_ENTRY.
+     */
+    explicit InferenceEngine(const ModelBundle& bundle);
+
+    InferenceEngine(const InferenceEngine&) = delete;
+    InferenceEngine& operator=(const InferenceEngine&) = delete;
+
+    /**
+     * @brief Проверяет, загружена ли модель.
+     * @return true, если сериализованной модели нет.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Классифицирует пачку входов. Можно вызывать из любых потоков: пачки потоков,
+     * ожидающих сеть, выполняются вместе одним прямым проходом.
+     * @param inputs Подготовленные входы модели (см. Image::getModelInput).
+     * @return Результаты в порядке входов; пустой вектор, если сеть не загружена.
+     */
+    std::vector<EmotionPrediction> predict(const std::vector<cv::Mat>& inputs);
+
+    /**
+     * @brief Классифицирует пачку входов и сообщает время прямого прохода, в который они вошли.
+     * Остальное время вызова - ожидание, пока сеть занята проходами других потоков.
+     * @param inputs Подготовленные входы модели (см. Image::getModelInput).
+     * @param forward_ms Время прямого прохода в миллисекундах (0, если прохода не было).
+     * @return Результаты в порядке входов; пустой вектор, если сеть не загружена.
+     */
+    std::vector<EmotionPrediction> predict(const std::vector<cv::Mat>& inputs, double& forward_ms);
+
+    /**
+     * @brief Классифицирует лица изображения, формат совпадает с Model::predict.
+     * @param image Изображение с подготовленными ROI.
+     * @return Вектор строк с предсказанными эмоциями и их вероятностями.
+     */
+    std::vector<std::string> predict(Image& image);
+
+    /**
+     * @brief Получает количество выполненных прямых проходов.
+     * @return Количество прямых проходов; не больше количества вызовов predict.
+     */
+    uint64_t forwardCount() const;
+
+private:
+    /**
+     * @struct Request
+     * @brief Вызов predict, ожидающий прямого прохода. Живёт в стеке вызывающего потока.
+     */
+    struct Request {
+        const std::vector<cv::Mat>* inputs; ///< Входы вызова.
+        std::vector<EmotionPrediction> predictions; ///< Результаты в порядке входов.
+        std::exception_ptr error; ///< Исключение прямого прохода.
+        double forward_ms = 0.0; ///< Время прямого прохода, в который вошли входы.
+        bool done = false; ///< Прямой проход выполнен.
+    };
+
+    void forward(const std::vector<Request*>& batch);
+
+    std::vector<char> model_storage; ///< Содержимое файла модели (пусто при загрузке из пакета).
+    const char* model_data = nullptr; ///< Сериализованная модель.
+    size_t model_size = 0; ///< Размер сериализованной модели в байтах.
+
+    cv::dnn::Net network; ///< Единственная сеть; используется только потоком, выполняющим прямой проход.
+    bool network_loaded = false; ///< Выполнялась ли попытка разобрать модель.
+    std::vector<cv::Mat> inputs; ///< Входы объединённой пачки, переиспользуются между проходами.
+    cv::Mat blob; ///< Буфер входа сети, переиспользуется между проходами.
+    std::vector<cv::Mat> outputs; ///< Буфер выхода сети, переиспользуется между проходами.
+
+    std::vector<Request*> pending; ///< Вызовы, ожидающие следующего прямого прохода.
+    bool running = false; ///< Сеть выполняет прямой проход.
+    uint64_t forwards = 0; ///< Количество прямых проходов.
+    mutable std::mutex mutex; ///< Мьютекс для очереди вызовов.
+    std::condition_variable forward_finished; ///< Сигнал о завершении прямого прохода.
+};
+
+#endif
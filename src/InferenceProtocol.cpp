@@ -0,0 +1,274 @@
+/**
+ * @file InferenceProtocol.cpp
+ * @brief Реализация методов класса LocalSocket.
+ */
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include "InferenceProtocol.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: SIGPIPE отключается сервером через signal
+#endif
+
+/**
+ * @brief Заполняет адрес сокета домена Unix.
+ * @param path Путь к файлу сокета.
+ * @param address Адрес для заполнения.
+ * @return true, если путь помещается в адрес.
+ */
+static bool makeAddress(const std::string& path, sockaddr_un& address) {
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Invalid socket path " << path << std::endl;
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+/**
+ * @brief Конструктор принимает владение дескриптором.
+ * @param fd Дескриптор сокета.
+ */
+LocalSocket::LocalSocket(int fd) : fd(fd) {}
+
+/**
+ * @brief Деструктор закрывает сокет.
+ */
+LocalSocket::~LocalSocket() {
+    close();
+}
+
+/**
+ * @brief Конструктор перемещения.
+ * @param other Сокет, владение которым передаётся.
+ */
+LocalSocket::LocalSocket(LocalSocket&& other) noexcept : fd(other.fd) {
+    other.fd = -1;
+}
+
+/**
+ * @brief Оператор перемещения.
+ * @param other Сокет, владение которым передаётся.
+ * @return Ссылка на этот сокет.
+ */
+LocalSocket& LocalSocket::operator=(LocalSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        other.fd = -1;
+    }
+    return *this;
+}
+
+/**
+ * @brief Создаёт слушающий сокет.
+ * @param path Путь к файлу сокета.
+ * @return Слушающий сокет.
+ */
+LocalSocket LocalSocket::listen(const std::string& path) {
+    sockaddr_un address;
+    if (!makeAddress(path, address)) {
+        return LocalSocket();
+    }
+
+    LocalSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (!socket.isOpen()) {
+        std::cerr << "Unable to create socket: " << std::strerror(errno) << std::endl;
+        return LocalSocket();
+    }
+
+    // Сокет, оставшийся от завершившегося сервера, мешает bind. Удаляется только файл сокета,
+    // к которому никто не подключён: другие файлы и сокет работающего сервера не трогаются
+    struct stat info;
+    if (::lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            std::cerr << "Unable to listen on " << path << ": file exists and is not a socket" << std::endl;
+            return LocalSocket();
+        }
+        LocalSocket probe(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if (probe.isOpen() && ::connect(probe.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            std::cerr << "Unable to listen on " << path << ": another server is running" << std::endl;
+            return LocalSocket();
+        }
+        ::unlink(path.c_str());
+    }
+    if (::bind(socket.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(socket.fd, SOMAXCONN) != 0) {
+        std::cerr << "Unable to listen on " << path << ": " << std::strerror(errno) << std::endl;
+        return LocalSocket();
+    }
+    return socket;
+}
+
+/**
+ * @brief Подключается к слушающему сокету.
+ * @param path Путь к файлу сокета.
+ * @return Подключённый сокет.
+ */
+LocalSocket LocalSocket::connect(const std::string& path) {
+    sockaddr_un address;
+    if (!makeAddress(path, address)) {
+        return LocalSocket();
+    }
+
+    LocalSocket socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (!socket.isOpen() ||
+        ::connect(socket.fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Unable to connect to " << path << ": " << std::strerror(errno) << std::endl;
+        return LocalSocket();
+    }
+    return socket;
+}
+
+/**
+ * @brief Принимает подключение, ожидая не дольше заданного времени.
+ * @param timeout_ms Время ожидания в миллисекундах.
+ * @return Подключённый сокет.
+ */
+LocalSocket LocalSocket::accept(int timeout_ms) {
+    pollfd descriptor = {fd, POLLIN, 0};
+    if (::poll(&descriptor, 1, timeout_ms) <= 0) {
+        return LocalSocket();
+    }
+    return LocalSocket(::accept(fd, nullptr, nullptr));
+}
+
+/**
+ * @brief Читает ровно size байт.
+ * @param data Буфер для данных.
+ * @param size Количество байт.
+ * @return true, если прочитаны все байты.
+ */
+bool LocalSocket::readAll(void* data, size_t size) {
+    char* cursor = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t received = ::recv(fd, cursor, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        cursor += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+/**
+ * @brief Записывает ровно size байт.
+ * @param data Данные.
+ * @param size Количество байт.
+ * @return true, если записаны все байты.
+ */
+bool LocalSocket::writeAll(const void* data, size_t size) {
+    const char* cursor = static_cast<const char*>(data);
+    while (size > 0) {
+        // MSG_NOSIGNAL: закрытое соединение не должно завершать сервер сигналом SIGPIPE
+        ssize_t sent = ::send(fd, cursor, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        cursor += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/**
+ * @brief Отправляет запрос: заголовок и данные.
+ * @param header Заголовок запроса.
+ * @param payload Данные запроса.
+ * @return true, если запрос отправлен целиком.
+ */
+bool LocalSocket::writeRequest(const RequestHeader& header, const void* payload) {
+    return writeAll(&header, sizeof(header)) && writeAll(payload, header.payload_size);
+}
+
+/**
+ * @brief Читает запрос и проверяет его заголовок.
+ * @param header Заголовок запроса.
+ * @param payload Буфер для данных.
+ * @return true, если прочитан корректный запрос.
+ */
+bool LocalSocket::readRequest(RequestHeader& header, std::vector<unsigned char>& payload) {
+    if (!readAll(&header, sizeof(header))) {
+        return false;
+    }
+    if (header.magic != REQUEST_MAGIC || header.payload_size > PROTOCOL_MAX_PAYLOAD) {
+        std::cerr << "Malformed request" << std::endl;
+        return false;
+    }
+
+    payload.resize(header.payload_size);
+    return readAll(payload.data(), payload.size());
+}
+
+/**
+ * @brief Отправляет ответ: заголовок и записи лиц.
+ * @param header Заголовок ответа.
+ * @param faces Результаты для лиц.
+ * @return true, если ответ отправлен целиком.
+ */
+bool LocalSocket::writeResponse(ResponseHeader header, const std::vector<FaceResult>& faces) {
+    header.face_count = static_cast<uint32_t>(faces.size());
+    return writeAll(&header, sizeof(header)) && writeAll(faces.data(), faces.size() * sizeof(FaceResult));
+}
+
+/**
+ * @brief Читает ответ и проверяет его заголовок.
+ * @param header Заголовок ответа.
+ * @param faces Результаты для лиц.
+ * @return true, если прочитан корректный ответ.
+ */
+bool LocalSocket::readResponse(ResponseHeader& header, std::vector<FaceResult>& faces) {
+    if (!readAll(&header, sizeof(header))) {
+        return false;
+    }
+    if (header.magic != RESPONSE_MAGIC || header.face_count > PROTOCOL_MAX_FACES) {
+        std::cerr << "Malformed response" << std::endl;
+        return false;
+    }
+
+    faces.resize(header.face_count);
+    return readAll(faces.data(), faces.size() * sizeof(FaceResult));
+}
+
+/**
+ * @brief Прерывает чтение и запись в других потоках, не закрывая дескриптор.
+ */
+void LocalSocket::shutdown() {
+    if (fd >= 0) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+}
+
+/**
+ * @brief Проверяет, открыт ли сокет.
+ * @return true, если сокет открыт.
+ */
+bool LocalSocket::isOpen() const {
+    return fd >= 0;
+}
+
+/**
+ * @brief Закрывает сокет.
+ */
+void LocalSocket::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
@@ -0,0 +1,211 @@
+/**
+ * @file InferenceProtocol.h
+ * @brief Протокол сервера предсказаний и класс LocalSocket.
+ */
+
+#ifndef INFERENCEPROTOCOL_H
+#define INFERENCEPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Сигнатура запроса ("EMRQ").
+ */
+static const uint32_t REQUEST_MAGIC = 0x51524D45;
+/**
+ * @brief Сигнатура ответа ("EMRS").
+ */
+static const uint32_t RESPONSE_MAGIC = 0x53524D45;
+/**
+ * @brief Сторона квадратного входа модели в пикселях.
+ */
+static const int PROTOCOL_FACE_SIZE = 48;
+/**
+ * @brief Количество классов эмоций в ответе.
+ */
+static const int PROTOCOL_CLASS_COUNT = 7;
+/**
+ * @brief Наибольший допустимый размер данных запроса.
+ */
+static const uint32_t PROTOCOL_MAX_PAYLOAD = 32u << 20;
+/**
+ * @brief Наибольшее допустимое количество лиц в ответе.
+ */
+static const uint32_t PROTOCOL_MAX_FACES = PROTOCOL_MAX_PAYLOAD / (PROTOCOL_FACE_SIZE * PROTOCOL_FACE_SIZE);
+
+/**
+ * @brief Вид запроса.
+ */
+enum RequestKind : uint32_t {
+    REQUEST_ENCODED_FRAME = 1, ///< Кадр в формате JPEG/PNG; сервер сам ищет лица.
+    REQUEST_FACES = 2 ///< Одно или несколько вырезанных лиц 48x48 в градациях серого, 8 бит, подряд.
+};
+
+/**
+ * @brief Код результата ответа.
+ */
+enum ResponseStatus : uint32_t {
+    RESPONSE_OK = 0, ///< Запрос выполнен.
+    RESPONSE_BAD_REQUEST = 1, ///< Неизвестный вид запроса или неверный размер данных.
+    RESPONSE_DECODE_FAILED = 2, ///< Не удалось декодировать кадр.
+    RESPONSE_INFERENCE_FAILED = 3 ///< Ошибка модели.
+};
+
+/**
+ * @struct RequestHeader
+ * @brief Заголовок запроса; за ним следуют payload_size байт данных.
+ */
+struct RequestHeader {
+    uint32_t magic; ///< REQUEST_MAGIC.
+    uint32_t kind; ///< Вид запроса (RequestKind).
+    uint32_t request_id; ///< Идентификатор, возвращаемый в ответе.
+    uint32_t payload_size; ///< Размер данных в байтах.
+};
+
+/**
+ * @struct ResponseHeader
+ * @brief Заголовок ответа; за ним следуют face_count записей FaceResult.
+ */
+struct ResponseHeader {
+    uint32_t magic; ///< RESPONSE_MAGIC.
+    uint32_t status; ///< Код результата (ResponseStatus).
+    uint32_t request_id; ///< Идентификатор из запроса.
+    uint32_t face_count; ///< Количество лиц.
+};
+
+/**
+ * @struct FaceResult
+ * @brief Результат для одного лица.
+ */
+struct FaceResult {
+    int32_t x; ///< Рамка лица в кадре (нули для вырезанных лиц).
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    int32_t class_id; ///< ID класса с наибольшей вероятностью (-1, если сеть не загружена).
+    float probability; ///< Вероятность этого класса.
+    float scores[PROTOCOL_CLASS_COUNT]; ///< Вероятности всех классов.
+};
+
+/**
+ * @class LocalSocket
+ * @brief Потоковый сокет домена Unix с чтением и записью сообщений целиком.
+ */
+class LocalSocket {
+
+public:
+    /**
+     * @brief Конструктор пустого сокета.
+     */
+    LocalSocket() = default;
+
+    /**
+     * @brief Конструктор принимает владение дескриптором.
+     * @param fd Дескриптор сокета.
+     */
+    explicit LocalSocket(int fd);
+
+    /**
+     * @brief Деструктор закрывает сокет.
+     */
+    ~LocalSocket();
+
+    LocalSocket(const LocalSocket&) = delete;
+    LocalSocket& operator=(const LocalSocket&) = delete;
+    LocalSocket(LocalSocket&& other) noexcept;
+    LocalSocket& operator=(LocalSocket&& other) noexcept;
+
+    /**
+     * @brief Создаёт слушающий сокет. Файл сокета, оставшийся от завершившегося сервера,
+     * удаляется; если путь занят другим файлом или работающим сервером, сокет не создаётся.
+     * @param path Путь к файлу сокета.
+     * @return Слушающий сокет (пустой при ошибке).
+     */
+    static LocalSocket listen(const std::string& path);
+
+    /**
+     * @brief Подключается к слушающему сокету.
+     * @param path Путь к файлу сокета.
+     * @return Подключённый сокет (пустой при ошибке).
+     */
+    static LocalSocket connect(const std::string& path);
+
+    /**
+     * @brief Принимает подключение, ожидая не дольше заданного времени.
+     * @param timeout_ms Время ожидания в миллисекундах.
+     * @return Подключённый сокет (пустой, если подключения не было).
+     */
+    LocalSocket accept(int timeout_ms);
+
+    /**
+     * @brief Читает ровно size байт.
+     * @param data Буфер для данных.
+     * @param size Количество байт.
+     * @return true, если прочитаны все байты; false при ошибке или закрытии соединения.
+     */
+    bool readAll(void* data, size_t size);
+
+    /**
+     * @brief Записывает ровно size байт.
+     * @param data Данные.
+     * @param size Количество байт.
+     * @return true, если записаны все байты.
+     */
+    bool writeAll(const void* data, size_t size);
+
+    /**
+     * @brief Отправляет запрос: заголовок и данные.
+     * @param header Заголовок запроса; payload_size задаёт размер данных.
+     * @param payload Данные запроса.
+     * @return true, если запрос отправлен целиком.
+     */
+    bool writeRequest(const RequestHeader& header, const void* payload);
+
+    /**
+     * @brief Читает запрос и проверяет его заголовок.
+     * @param header Заголовок запроса.
+     * @param payload Буфер для данных, память переиспользуется между запросами.
+     * @return true, если прочитан корректный запрос; false при закрытии соединения или неверном заголовке.
+     */
+    bool readRequest(RequestHeader& header, std::vector<unsigned char>& payload);
+
+    /**
+     * @brief Отправляет ответ: заголовок и записи лиц. Поле face_count заполняется по faces.
+     * @param header Заголовок ответа.
+     * @param faces Результаты для лиц.
+     * @return true, если ответ отправлен целиком.
+     */
+    bool writeResponse(ResponseHeader header, const std::vector<FaceResult>& faces);
+
+    /**
+     * @brief Читает ответ и проверяет его заголовок.
+     * @param header Заголовок ответа.
+     * @param faces Результаты для лиц.
+     * @return true, если прочитан корректный ответ; false при закрытии соединения или неверном заголовке.
+     */
+    bool readResponse(ResponseHeader& header, std::vector<FaceResult>& faces);
+
+    /**
+     * @brief Прерывает ожидающие чтение и запись (например, из другого потока при остановке).
+     */
+    void shutdown();
+
+    /**
+     * @brief Проверяет, открыт ли сокет.
+     * @return true, если сокет открыт.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Закрывает сокет.
+     */
+    void close();
+
+private:
+    int fd = -1; ///< Дескриптор сокета.
+};
+
+#endif
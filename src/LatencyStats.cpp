@@ -0,0 +1,108 @@
+/**
+ * @file LatencyStats.cpp
+ * @brief Реализация методов класса LatencyStats.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "LatencyStats.h"
+
+/**
+ * @brief Конструктор класса LatencyStats.
+ * @param capacity Количество последних измерений, по которым считаются перцентили.
+ */
+LatencyStats::LatencyStats(size_t capacity) : capacity(std::max<size_t>(1, capacity)) {
+    samples.reserve(std::min<size_t>(this->capacity, 4096));
+}
+
+/**
+ * @brief Добавляет измерение.
+ * @param milliseconds Задержка в миллисекундах.
+ */
+void LatencyStats::record(double milliseconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (samples.size() < capacity) {
+        samples.push_back(milliseconds);
+    } else {
+        samples[next] = milliseconds;
+    }
+    next = (next + 1) % capacity;
+
+    total++;
+    sum += milliseconds;
+    maximum = std::max(maximum, milliseconds);
+}
+
+/**
+ * @brief Получает количество измерений с последнего сброса.
+ * @return Количество измерений.
+ */
+size_t LatencyStats::count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return total;
+}
+
+/**
+ * @brief Вычисляет перцентиль по хранимым измерениям.
+ * @param p Перцентиль от 0 до 100.
+ * @return Задержка в миллисекундах.
+ */
+double LatencyStats::percentile(double p) const {
+    std::vector<double> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted = samples;
+    }
+    if (sorted.empty()) {
+        return 0.0;
+    }
+
+    // Ближайший ранг: наименьшее значение, не меньше которого p процентов измерений
+    p = std::min(100.0, std::max(0.0, p));
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    size_t index = rank > 0 ? rank - 1 : 0;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+/**
+ * @brief Получает среднюю задержку.
+ * @return Средняя задержка в миллисекундах.
+ */
+double LatencyStats::mean() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return total > 0 ? sum / total : 0.0;
+}
+
+/**
+ * @brief Получает максимальную задержку.
+ * @return Максимальная задержка в миллисекундах.
+ */
+double LatencyStats::max() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return maximum;
+}
+
+/**
+ * @brief Формирует строку со сводкой измерений.
+ * @return Строка для вывода в лог.
+ */
+std::string LatencyStats::summary() const {
+    char text[160];
+    std::snprintf(text, sizeof(text), "n=%zu mean=%.2fms p50=%.2fms p90=%.2fms p99=%.2fms max=%.2fms",
+                  count(), mean(), percentile(50), percentile(90), percentile(99), max());
+    return text;
+}
+
+/**
+ * @brief Удаляет все измерения.
+ */
+void LatencyStats::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    samples.clear();
+    next = 0;
+    total = 0;
+    sum = 0.0;
+    maximum = 0.0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file LatencyStats.h
+ * @brief Объявление класса LatencyStats.
+ */
+
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class LatencyStats
+ * @brief Потокобезопасный сбор задержек с расчётом перцентилей.
+ * Хранит последние capacity измерений в кольцевом буфере; счётчик, среднее и максимум
+ * учитывают все измерения с последнего сброса.
+ */
+class LatencyStats {
+
+public:
+    /**
+     * @brief Конструктор класса LatencyStats.
+     * @param capacity Количество последних измерений, по которым считаются перцентили.
+     */
+    explicit LatencyStats(size_t capacity = 100000);
+
+    /**
+     * @brief Добавляет измерение.
+     * @param milliseconds Задержка в миллисекундах.
+     */
+    void record(double milliseconds);
+
+    /**
+     * @brief Получает количество измерений с последнего сброса.
+     * @return Количество измерений.
+     */
+    size_t count() const;
+
+    /**
+     * @brief Вычисляет перцентиль по хранимым измерениям (метод ближайшего ранга).
+     * @param p Перцентиль от 0 до 100.
+     * @return Задержка в миллисекундах; 0, если измерений нет.
+     */
+    double percentile(double p) const;
+
+    /**
+     * @brief Получает среднюю задержку.
+     * @return Средняя задержка в миллисекундах.
+     */
+    double mean() const;
+
+    /**
+     * @brief Получает максимальную задержку.
+     * @return Максимальная задержка в миллисекундах.
+     */
+    double max() const;
+
+    /**
+     * @brief Формирует строку с количеством, средним и перцентилями p50/p90/p99.
+     * @return Строка для вывода в лог.
+     */
+    std::string summary() const;
+
+    /**
+     * @brief Удаляет все измерения.
+     */
+    void reset();
+
+private:
+    size_t capacity; ///< Размер кольцевого буфера.
+    std::vector<double> samples; ///< Последние измерения.
+    size_t next = 0; ///< Позиция следующей записи в кольцевом буфере.
+    size_t total = 0; ///< Количество измерений с последнего сброса.
+    double sum = 0.0; ///< Сумма всех измерений.
+    double maximum = 0.0; ///< Максимальное измерение.
+    mutable std::mutex mutex; ///< Мьютекс для измерений.
+};
+
+#endif
@@ -4,66 +4,100 @@
  * @brief Реализация методов класса Model.
  */
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/dnn.hpp>
+#include <algorithm>
+#include <cctype>
 #include "Model.h"
 
+/**
+ * @brief Отображение от ID класса к меткам классов.
+ */
+static const std::map<int, std::string> CLASSID_TO_STRING = {{0, "Angry"},
+                                                             {1, "Disgust"},
+                                                             {2, "Fear"},
+                                                             {3, "Happy"},
+                                                             {4, "Sad"},
+                                                             {5, "Surprise"},
+                                                             {6, "Neutral"}};
+
+/**
+ * @brief Загружает сеть из записи пакета моделей.
+ * @param bundle Открытый пакет моделей.
+ * @return Нейронная сеть (пустая, если записи модели нет).
+ */
+static cv::dnn::Net readNetFromBundle(const ModelBundle& bundle) {
+    const char* data = nullptr;
+    size_t size = 0;
+    if (!bundle.find(ModelBundle::MODEL_ENTRY, data, size)) {
+        std::cerr << "Model bundle has no " << ModelBundle::MODEL_ENTRY << " entry" << std::endl;
+        return cv::dnn::Net();
+    }
+    return cv::dnn::readNetFromTensorflow(data, size);
+}
+
 /**
  * @brief Конструктор класса Model.
  * @param model_filename Путь к файлу модели TensorFlow.
  */
 Model::Model(const std::string& model_filename) 
     : network(cv::dnn::readNet(model_filename)), // Загрузка модели TensorFlow
-      classid_to_string({{0, "Angry"}, 
-                         {1, "Disgust"}, 
-                         {2, "Fear"}, 
-                         {3, "Happy"}, 
-                         {4, "Sad"}, 
-                         {5, "Surprise"}, 
-                         {6, "Neutral"}}) // Создание отображения от ID класса к меткам классов
+      classid_to_string(CLASSID_TO_STRING) // Создание отображения от ID класса к меткам классов
 {}
 
 /**
- * @brief Выполняет предсказание эмоций на основе входного изображения.
- * @param image Изображение для предсказания.
- * @return Вектор строк с предсказанными эмоциями и их вероятностями.
+ * @brief Конструктор класса Model.
+ * @param bundle Открытый пакет моделей.
  */
-std::vector<std::string> Model::predict(Image& image) {
-    // Извлечение изображений областей интереса (ROI) для входа в модель
-    std::vector<cv::Mat> roi_image = image.getModelInput();
-    std::vector<std::string> emotion_prediction;
+Model::Model(const ModelBundle& bundle)
+    : network(readNetFromBundle(bundle)), // Загрузка модели TensorFlow из отображённой памяти
+      classid_to_string(CLASSID_TO_STRING)
+{}
 
-    if (roi_image.size() > 0) { 
-        for (int i = 0; i < roi_image.size(); i++) {
-            // Конвертация в blob
-            cv::Mat blob = cv::dnn::blobFromImage(roi_image[i]);
+/**
+ * @brief Классифицирует одно лицо.
+ * @param input Предобработанное лицо (элемент Image::getModelInput).
+ * @return Результат классификации.
+ */
+EmotionPrediction Model::classifyFace(const cv::Mat& input) {
+    // Конвертация в blob
+    cv::Mat blob = cv::dnn::blobFromImage(input);
 
-            // Передача blob в сеть
-            this->network.setInput(blob);
+    // Передача blob в сеть
+    this->network.setInput(blob);
 
-            // Прямой проход по сети
-            cv::Mat prob = this->network.forward();
+    // Прямой проход по сети
+    cv::Mat prob = this->network.forward();
 
-            // Сортировка вероятностей и индексов
-            cv::Mat sorted_probabilities;
-            cv::Mat sorted_ids;
-            cv::sort(prob.reshape(1, 1), sorted_probabilities, cv::SORT_DESCENDING);
-            cv::sortIdx(prob.reshape(1, 1), sorted_ids, cv::SORT_DESCENDING);
+    return toPrediction(prob);
+}
 
-            // Получение наивысшей вероятности и соответствующего ID класса
-            float top_probability = sorted_probabilities.at<float>(0);
-            int top_class_id = sorted_ids.at<int>(0);
+/**
+ * @brief Классифицирует все лица изображения.
+ * @param image Изображение для предсказания.
+ * @return Результаты классификации в порядке лиц.
+ */
+std::vector<EmotionPrediction> Model::classify(Image& image) {
+    // Извлечение изображений областей интереса (ROI) для входа в модель
+    std::vector<cv::Mat> roi_image = image.getModelInput();
+    std::vector<EmotionPrediction> predictions;
 
-            // Отображение ID класса на название класса (например, happy, sad, angry, disgust и т.д.)
-            std::string class_name = this->classid_to_string.at(top_class_id);
+    for (int i = 0; i < roi_image.size(); i++) {
+        predictions.push_back(classifyFace(roi_image[i]));
+    }
 
-            // Строка с результатом предсказания для вывода
-            std::string result_string = class_name + ": " + std::to_string(top_probability * 100) + "%";
+    return predictions;
+}
 
-            // Добавление результата в вектор предсказаний
-            emotion_prediction.push_back(result_string);
-        }
+/**
+ * @brief Выполняет предсказание эмоций на основе входного изображения.
+ * @param image Изображение для предсказания.
+ * @return Вектор строк с предсказанными эмоциями и их вероятностями.
+ */
+std::vector<std::string> Model::predict(Image& image) {
+    std::vector<std::string> emotion_prediction;
+    for (const EmotionPrediction& prediction : classify(image)) {
+        emotion_prediction.push_back(formatPrediction(prediction));
     }
-
     return emotion_prediction;
 }
 
@@ -111,3 +145,73 @@ std::string Model::ans(Image& image) {
 
     return emotion_prediction.size() > 0 ? emotion_prediction[0] : "";
 }
+
+/**
+ * @brief Строит результат классификации по строке вероятностей сети.
+ * @param scores Вероятности классов.
+ * @return Результат с наиболее вероятным классом.
+ */
+EmotionPrediction Model::toPrediction(const cv::Mat& scores) {
+    EmotionPrediction prediction;
+    cv::Mat row = scores.reshape(1, 1);
+    prediction.scores.assign(row.ptr<float>(0), row.ptr<float>(0) + row.cols);
+
+    // Наиболее вероятный класс; при равенстве выигрывает меньший ID
+    for (int i = 0; i < static_cast<int>(prediction.scores.size()); i++) {
+        if (prediction.class_id < 0 || prediction.scores[i] > prediction.probability) {
+            prediction.class_id = i;
+            prediction.probability = prediction.scores[i];
+        }
+    }
+    return prediction;
+}
+
+/**
+ * @brief Форматирует результат классификации.
+ * @param prediction Результат классификации.
+ * @return Строка с названием эмоции и вероятностью в процентах.
+ */
+std::string Model::formatPrediction(const EmotionPrediction& prediction) {
+    // Отображение ID класса на название класса (например, happy, sad, angry, disgust и т.д.)
+    std::string class_name = CLASSID_TO_STRING.at(prediction.class_id);
+    return class_name + ": " + std::to_string(prediction.probability * 100) + "%";
+}
+
+/**
+ * @brief Получает количество классов эмоций.
+ * @return Количество классов.
+ */
+int Model::classCount() {
+    return static_cast<int>(CLASSID_TO_STRING.size());
+}
+
+/**
+ * @brief Получает название класса по ID.
+ * @param class_id ID класса.
+ * @return Название класса.
+ */
+std::string Model::className(int class_id) {
+    auto it = CLASSID_TO_STRING.find(class_id);
+    return it != CLASSID_TO_STRING.end() ? it->second : std::string();
+}
+
+/**
+ * @brief Получает ID класса по названию без учёта регистра.
+ * @param name Название класса.
+ * @return ID класса или -1.
+ */
+int Model::classId(const std::string& name) {
+    auto lower = [](std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    };
+
+    std::string key = lower(name);
+    for (const auto& entry : CLASSID_TO_STRING) {
+        if (lower(entry.second) == key) {
+            return entry.first;
+        }
+    }
+    return -1;
+}
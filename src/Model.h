@@ -6,9 +6,24 @@
 #ifndef MODEL_H
 #define MODEL_H
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/dnn.hpp>
 #include <iostream>
+#include <map>
+#include <string>
+#include <vector>
 #include "Image.h"
+#include "ModelBundle.h"
+
+/**
+ * @struct EmotionPrediction
+ * @brief Результат классификации одного лица.
+ */
+struct EmotionPrediction {
+    int class_id = -1; ///< ID класса с наибольшей вероятностью.
+    float probability = 0.0f; ///< Вероятность этого класса.
+    std::vector<float> scores; ///< Вероятности всех классов.
+};
 
 /**
  * @class Model
@@ -22,6 +37,12 @@ public:
      */
     Model(const std::string& model_filename);
 
+    /**
+     * @brief Конструктор загружает модель TensorFlow из пакета моделей, отображённого в память.
+     * @param bundle Открытый пакет моделей с записью ModelBundle::MODEL_ENTRY.
+     */
+    explicit Model(const ModelBundle& bundle);
+
     /**
      * @brief Деструктор класса Model.
      */
@@ -34,6 +55,20 @@ public:
      */
     std::vector<std::string> predict(Image& image);
 
+    /**
+     * @brief Классифицирует все лица изображения.
+     * @param image Изображение для предсказания.
+     * @return Результаты классификации с вероятностями всех классов в порядке лиц.
+     */
+    std::vector<EmotionPrediction> classify(Image& image);
+
+    /**
+     * @brief Классифицирует одно лицо, чтобы вызывающий мог ограничить число предсказаний на кадр.
+     * @param input Предобработанное лицо (элемент Image::getModelInput).
+     * @return Результат классификации.
+     */
+    EmotionPrediction classifyFace(const cv::Mat& input);
+
     /**
      * @brief Функция предсказания модели, принимает изображение на вход и возвращает первую предсказанную эмоцию.
      * @param image Изображение для предсказания.
@@ -41,6 +76,40 @@ public:
      */
     std::string ans(Image& image);
 
+    /**
+     * @brief Строит результат классификации по строке вероятностей сети.
+     * @param scores Вероятности классов (одна строка выхода сети, CV_32F).
+     * @return Результат с наиболее вероятным классом.
+     */
+    static EmotionPrediction toPrediction(const cv::Mat& scores);
+
+    /**
+     * @brief Форматирует результат классификации так же, как predict.
+     * @param prediction Результат классификации.
+     * @return Строка вида "Happy: 93.000000%".
+     */
+    static std::string formatPrediction(const EmotionPrediction& prediction);
+
+    /**
+     * @brief Получает количество классов эмоций.
+     * @return Количество классов.
+     */
+    static int classCount();
+
+    /**
+     * @brief Получает название класса по ID.
+     * @param class_id ID класса.
+     * @return Название (например, "Happy"); пустая строка для неизвестного ID.
+     */
+    static std::string className(int class_id);
+
+    /**
+     * @brief Получает ID класса по названию без учёта регистра (например, имя каталога набора данных).
+     * @param name Название класса.
+     * @return ID класса или -1, если название неизвестно.
+     */
+    static int classId(const std::string& name);
+
 private:
     cv::dnn::Net network; ///< Нейронная сеть модели.
     std::map<int, std::string> classid_to_string; ///< Отображение ID класса в строковую метку.
@@ -0,0 +1,286 @@
+/**
+ * @file ModelBundle.cpp
+ * @brief Реализация методов класса ModelBundle.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "ModelBundle.h"
+
+#ifndef EMOTION_MODEL_DIR
+#define EMOTION_MODEL_DIR "../model"
+#endif
+
+#ifndef EMOTION_BUNDLE_PATH
+#define EMOTION_BUNDLE_PATH "emotion_models.bundle"
+#endif
+
+const char* const ModelBundle::CASCADE_ENTRY = "cascade";
+const char* const ModelBundle::MODEL_ENTRY = "model";
+const char* const ModelBundle::DEFAULT_PATH = EMOTION_BUNDLE_PATH;
+const char* const ModelBundle::DEFAULT_CASCADE_PATH = EMOTION_MODEL_DIR "/haarcascade_frontalface_alt2.xml";
+const char* const ModelBundle::DEFAULT_MODEL_PATH = EMOTION_MODEL_DIR "/tensorflow_model.pb";
+
+/**
+ * @brief Сигнатура файла пакета.
+ */
+static const char BUNDLE_MAGIC[8] = {'E', 'M', 'O', 'B', 'N', 'D', 'L', '\0'};
+/**
+ * @brief Версия формата пакета.
+ */
+static const uint32_t BUNDLE_VERSION = 1;
+/**
+ * @brief Выравнивание данных записей.
+ */
+static const uint64_t BUNDLE_ALIGNMENT = 64;
+/**
+ * @brief Максимальная длина имени записи, включая завершающий ноль.
+ */
+static const size_t BUNDLE_NAME_SIZE = 32;
+
+/**
+ * @struct BundleHeader
+ * @brief Заголовок файла пакета.
+ */
+struct BundleHeader {
+    char magic[8]; ///< Сигнатура "EMOBNDL\0".
+    uint32_t version; ///< Версия формата.
+    uint32_t entry_count; ///< Количество записей.
+};
+
+/**
+ * @struct BundleEntry
+ * @brief Запись таблицы в файле пакета.
+ */
+struct BundleEntry {
+    char name[BUNDLE_NAME_SIZE]; ///< Имя записи.
+    uint64_t offset; ///< Смещение данных от начала файла.
+    uint64_t size; ///< Размер данных.
+    uint32_t crc; ///< CRC-32 данных.
+    uint32_t reserved; ///< Зарезервировано.
+};
+
+/**
+ * @brief Деструктор снимает отображение файла.
+ */
+ModelBundle::~ModelBundle() {
+    close();
+}
+
+/**
+ * @brief Отображает пакет в память и проверяет заголовок и таблицу записей.
+ * @param filename Путь к файлу пакета.
+ * @param verify Проверять CRC-32 всех записей.
+ * @return true, если пакет корректен.
+ */
+bool ModelBundle::open(const std::string& filename, bool verify) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Unable to open model bundle " << filename << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(BundleHeader))) {
+        std::cerr << "Model bundle " << filename << " is truncated" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Unable to map model bundle " << filename << std::endl;
+        return false;
+    }
+    mapping = mapped;
+    mapping_size = info.st_size;
+
+    const char* base = static_cast<const char*>(mapping);
+    BundleHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    if (std::memcmp(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0 || header.version != BUNDLE_VERSION) {
+        std::cerr << "Model bundle " << filename << " has unsupported format" << std::endl;
+        close();
+        return false;
+    }
+
+    size_t table_end = sizeof(BundleHeader) + static_cast<size_t>(header.entry_count) * sizeof(BundleEntry);
+    if (table_end > mapping_size) {
+        std::cerr << "Model bundle " << filename << " is truncated" << std::endl;
+        close();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header.entry_count; i++) {
+        BundleEntry record;
+        std::memcpy(&record, base + sizeof(BundleHeader) + i * sizeof(BundleEntry), sizeof(record));
+        record.name[BUNDLE_NAME_SIZE - 1] = '\0';
+
+        if (record.offset > mapping_size || record.size > mapping_size - record.offset) {
+            std::cerr << "Model bundle entry " << record.name << " is out of bounds" << std::endl;
+            close();
+            return false;
+        }
+
+        const char* data = base + record.offset;
+        if (verify && crc32(data, record.size) != record.crc) {
+            std::cerr << "Model bundle entry " << record.name << " failed checksum verification" << std::endl;
+            close();
+            return false;
+        }
+
+        entries.push_back({record.name, data, static_cast<size_t>(record.size)});
+    }
+
+    return true;
+}
+
+/**
+ * @brief Открывает пакет, заданный в командной строке.
+ * @param filename Путь к файлу пакета.
+ * @param required Пакет задан явно.
+ * @param verify Проверять CRC-32 всех записей.
+ * @return false, если явно заданный пакет не удалось открыть.
+ */
+bool ModelBundle::openForCli(const std::string& filename, bool required, bool verify) {
+    if (filename.empty() || (!required && !std::filesystem::exists(filename))) {
+        return true;
+    }
+    return open(filename, verify) || !required;
+}
+
+/**
+ * @brief Снимает отображение файла.
+ */
+void ModelBundle::close() {
+    if (mapping) {
+        munmap(mapping, mapping_size);
+    }
+    mapping = nullptr;
+    mapping_size = 0;
+    entries.clear();
+}
+
+/**
+ * @brief Проверяет, открыт ли пакет.
+ * @return true, если пакет открыт.
+ */
+bool ModelBundle::isOpen() const {
+    return mapping != nullptr;
+}
+
+/**
+ * @brief Ищет запись пакета.
+ * @param name Имя записи.
+ * @param data Указатель на данные записи.
+ * @param size Размер данных записи.
+ * @return true, если запись найдена.
+ */
+bool ModelBundle::find(const std::string& name, const char*& data, size_t& size) const {
+    for (const Entry& entry : entries) {
+        if (entry.name == name) {
+            data = entry.data;
+            size = entry.size;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Упаковывает файлы в пакет.
+ * @param filename Путь к создаваемому пакету.
+ * @param entries Пары {имя записи, путь к файлу}.
+ * @return true, если пакет записан.
+ */
+bool ModelBundle::write(const std::string& filename, const std::vector<std::pair<std::string, std::string>>& entries) {
+    std::vector<std::string> contents;
+    std::vector<BundleEntry> records;
+    uint64_t offset = sizeof(BundleHeader) + entries.size() * sizeof(BundleEntry);
+
+    for (const auto& entry : entries) {
+        if (entry.first.size() >= BUNDLE_NAME_SIZE) {
+            std::cerr << "Model bundle entry name " << entry.first << " is too long" << std::endl;
+            return false;
+        }
+
+        std::ifstream input(entry.second, std::ios::binary);
+        if (!input.is_open()) {
+            std::cerr << "Unable to open file " << entry.second << std::endl;
+            return false;
+        }
+        contents.emplace_back(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+
+        offset = (offset + BUNDLE_ALIGNMENT - 1) / BUNDLE_ALIGNMENT * BUNDLE_ALIGNMENT;
+
+        BundleEntry record = {};
+        std::strncpy(record.name, entry.first.c_str(), BUNDLE_NAME_SIZE - 1);
+        record.offset = offset;
+        record.size = contents.back().size();
+        record.crc = crc32(contents.back().data(), contents.back().size());
+        records.push_back(record);
+
+        offset += record.size;
+    }
+
+    BundleHeader header = {};
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+    header.version = BUNDLE_VERSION;
+    header.entry_count = static_cast<uint32_t>(records.size());
+
+    std::ofstream output(filename, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        std::cerr << "Unable to open file " << filename << std::endl;
+        return false;
+    }
+
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BundleEntry));
+
+    for (size_t i = 0; i < records.size(); i++) {
+        // Выравнивание данных записи нулями
+        std::string padding(records[i].offset - static_cast<uint64_t>(output.tellp()), '\0');
+        output.write(padding.data(), padding.size());
+        output.write(contents[i].data(), contents[i].size());
+    }
+
+    return output.good();
+}
+
+/**
+ * @brief Вычисляет контрольную сумму CRC-32 (IEEE 802.3).
+ * @param data Данные.
+ * @param size Размер данных.
+ * @return Контрольная сумма.
+ */
+uint32_t ModelBundle::crc32(const char* data, size_t size) {
+    static uint32_t table[256] = {};
+    static bool table_ready = [] {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)table_ready;
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file ModelBundle.h
+ * @brief Объявление класса ModelBundle.
+ */
+
+#ifndef MODELBUNDLE_H
+#define MODELBUNDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class ModelBundle
+ * @brief Версионированный бинарный пакет моделей (каскад лиц и веса сети) с контрольными суммами.
+ * Пакет отображается в память через mmap, поэтому при запуске не нужно читать файлы моделей
+ * по относительным путям. Записи хранят исходные XML каскада и .pb сети: OpenCV разбирает их
+ * из отображённой памяти так же, как из файлов, и время разбора при запуске не меняется.
+ *
+ * Формат (little-endian): заголовок {magic "EMOBNDL\0", версия, количество записей},
+ * таблица записей {имя, смещение, размер, CRC-32}, затем данные записей, выровненные по 64 байтам.
+ */
+class ModelBundle {
+
+public:
+    static const char* const CASCADE_ENTRY; ///< Имя записи каскада лиц.
+    static const char* const MODEL_ENTRY; ///< Имя записи модели TensorFlow.
+    static const char* const DEFAULT_PATH; ///< Пакет моделей по умолчанию, путь задаётся при сборке.
+    static const char* const DEFAULT_CASCADE_PATH; ///< Каскад лиц, если пакета моделей нет.
+    static const char* const DEFAULT_MODEL_PATH; ///< Модель TensorFlow, если пакета моделей нет.
+
+    /**
+     * @brief Конструктор пустого пакета.
+     */
+    ModelBundle() {};
+
+    /**
+     * @brief Деструктор снимает отображение файла.
+     */
+    ~ModelBundle();
+
+    ModelBundle(const ModelBundle&) = delete;
+    ModelBundle& operator=(const ModelBundle&) = delete;
+
+    /**
+     * @brief Отображает пакет в память и проверяет заголовок и таблицу записей.
+     * Контрольные суммы содержимого читают весь пакет, поэтому проверяются только по запросу.
+     * @param filename Путь к файлу пакета.
+     * @param verify Проверять CRC-32 всех записей.
+     * @return true, если пакет корректен.
+     */
+    bool open(const std::string& filename, bool verify = false);
+
+    /**
+     * @brief Открывает пакет, заданный в командной строке. Явно заданный пакет обязателен,
+     * пакет по умолчанию открывается, только если файл существует; без пакета модели читаются
+     * из DEFAULT_CASCADE_PATH и DEFAULT_MODEL_PATH.
+     * @param filename Путь к файлу пакета (пусто - не использовать пакет).
+     * @param required Пакет задан явно.
+     * @param verify Проверять CRC-32 всех записей (--verify-bundle).
+     * @return false, если явно заданный пакет не удалось открыть; причина уже выведена.
+     */
+    bool openForCli(const std::string& filename, bool required, bool verify = false);
+
+    /**
+     * @brief Снимает отображение файла.
+     */
+    void close();
+
+    /**
+     * @brief Проверяет, открыт ли пакет.
+     * @return true, если пакет открыт.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Ищет запись пакета.
+     * @param name Имя записи.
+     * @param data Указатель на данные записи в отображённой памяти.
+     * @param size Размер данных записи.
+     * @return true, если запись найдена.
+     */
+    bool find(const std::string& name, const char*& data, size_t& size) const;
+
+    /**
+     * @brief Упаковывает файлы в пакет.
+     * @param filename Путь к создаваемому пакету.
+     * @param entries Пары {имя записи, путь к файлу}.
+     * @return true, если пакет записан.
+     */
+    static bool write(const std::string& filename, const std::vector<std::pair<std::string, std::string>>& entries);
+
+    /**
+     * @brief Вычисляет контрольную сумму CRC-32 (IEEE 802.3).
+     * @param data Данные.
+     * @param size Размер данных.
+     * @return Контрольная сумма.
+     */
+    static uint32_t crc32(const char* data, size_t size);
+
+private:
+    /**
+     * @struct Entry
+     * @brief Запись таблицы пакета.
+     */
+    struct Entry {
+        std::string name; ///< Имя записи.
+        const char* data; ///< Данные записи в отображённой памяти.
+        size_t size; ///< Размер данных записи.
+    };
+
+    void* mapping = nullptr; ///< Отображённый в память файл.
+    size_t mapping_size = 0; ///< Размер отображения.
+    std::vector<Entry> entries; ///< Записи пакета.
+};
+
+#endif
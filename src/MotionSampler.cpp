@@ -0,0 +1,96 @@
+/**
+ * @file MotionSampler.cpp
+ * @brief Реализация методов класса MotionSampler.
+ */
+
+#include <opencv2/imgproc.hpp>
+#include "MotionSampler.h"
+
+/**
+ * @brief Конструктор класса MotionSampler с параметрами по умолчанию.
+ */
+MotionSampler::MotionSampler() : MotionSampler(Settings()) {}
+
+/**
+ * @brief Конструктор класса MotionSampler.
+ * @param settings Параметры адаптивной выборки.
+ */
+MotionSampler::MotionSampler(const Settings& settings) : settings(settings) {}
+
+/**
+ * @brief Решает, нужно ли обрабатывать кадр.
+ * @param frame Декодированный кадр.
+ * @param timestamp Время кадра в секундах.
+ * @return true, если кадр нужно передать в детектор и модель.
+ */
+bool MotionSampler::shouldProcess(const cv::Mat& frame, double timestamp) {
+    last_timestamp = timestamp;
+    if (frame.empty()) {
+        return false;
+    }
+
+    // Уменьшение кадра до сравнения цвета: преобразование выполняется над маленьким изображением
+    cv::resize(frame, small_frame, settings.probe_size, 0, 0, cv::INTER_AREA);
+    if (small_frame.channels() == 3) {
+        cv::cvtColor(small_frame, small_gray, cv::COLOR_BGR2GRAY);
+    } else if (small_frame.channels() == 4) {
+        cv::cvtColor(small_frame, small_gray, cv::COLOR_BGRA2GRAY);
+    } else {
+        small_frame.copyTo(small_gray);
+    }
+
+    // Первый кадр всегда обрабатывается
+    if (reference.empty()) {
+        score = 1.0;
+        small_gray.copyTo(reference);
+        last_processed = timestamp;
+        return true;
+    }
+
+    // Средняя разность яркости с последним обработанным кадром
+    cv::absdiff(small_gray, reference, difference);
+    score = cv::mean(difference)[0] / 255.0;
+
+    bool changed = score > settings.threshold;
+    if (changed) {
+        dense_until = timestamp + settings.dense_window;
+    }
+
+    double elapsed = timestamp - last_processed;
+    bool dense = timestamp <= dense_until && elapsed >= settings.dense_interval;
+
+    if (changed || dense || elapsed >= settings.max_interval) {
+        small_gray.copyTo(reference);
+        last_processed = timestamp;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Шаг до следующего проверяемого кадра для видео с произвольным доступом.
+ * @return Интервал в секундах.
+ */
+double MotionSampler::nextInterval() const {
+    return last_timestamp < dense_until ? settings.dense_interval : settings.probe_interval;
+}
+
+/**
+ * @brief Получает оценку изменения сцены для последнего проверенного кадра.
+ * @return Средняя разность яркости с опорным кадром.
+ */
+double MotionSampler::lastScore() const {
+    return score;
+}
+
+/**
+ * @brief Сбрасывает опорный кадр.
+ */
+void MotionSampler::reset() {
+    reference.release();
+    last_processed = 0;
+    dense_until = -1;
+    last_timestamp = 0;
+    score = 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file MotionSampler.h
+ * @brief Объявление класса MotionSampler.
+ */
+
+#ifndef MOTIONSAMPLER_H
+#define MOTIONSAMPLER_H
+
+#include <opencv2/core.hpp>
+
+/**
+ * @class MotionSampler
+ * @brief Адаптивная выборка кадров по изменению сцены.
+ * Сразу после декодирования кадр уменьшается до маленького изображения в градациях серого
+ * и сравнивается с последним обработанным кадром. Детекция и предсказание выполняются только
+ * при заметном изменении сцены или по истечении максимального интервала, а после изменения
+ * некоторое время кадры анализируются чаще.
+ */
+class MotionSampler {
+
+public:
+    /**
+     * @struct Settings
+     * @brief Параметры адаптивной выборки.
+     */
+    struct Settings {
+        double threshold = 0.03; ///< Порог изменения сцены (средняя разность яркости, от 0 до 1).
+        double max_interval = 5.0; ///< Максимальный интервал между обработанными кадрами, с.
+        double probe_interval = 1.0; ///< Шаг проверки кадров видео в статичной сцене, с.
+        double dense_interval = 0.25; ///< Шаг проверки и обработки кадров после изменения сцены, с.
+        double dense_window = 3.0; ///< Длительность частой выборки после изменения сцены, с.
+        cv::Size probe_size = cv::Size(64, 36); ///< Размер уменьшенного кадра для сравнения.
+    };
+
+    /**
+     * @brief Конструктор класса MotionSampler с параметрами по умолчанию.
+     */
+    MotionSampler();
+
+    /**
+     * @brief Конструктор класса MotionSampler.
+     * @param settings Параметры адаптивной выборки.
+     */
+    explicit MotionSampler(const Settings& settings);
+
+    /**
+     * @brief Решает, нужно ли обрабатывать кадр. Если да, кадр становится опорным для следующих сравнений.
+     * @param frame Декодированный кадр.
+     * @param timestamp Время кадра в секундах.
+     * @return true, если кадр нужно передать в детектор и модель.
+     */
+    bool shouldProcess(const cv::Mat& frame, double timestamp);
+
+    /**
+     * @brief Шаг до следующего проверяемого кадра для видео с произвольным доступом.
+     * @return Интервал в секундах: частый после изменения сцены, обычный в статичной сцене.
+     */
+    double nextInterval() const;
+
+    /**
+     * @brief Получает оценку изменения сцены для последнего проверенного кадра.
+     * @return Средняя разность яркости с опорным кадром (от 0 до 1).
+     */
+    double lastScore() const;
+
+    /**
+     * @brief Сбрасывает опорный кадр (например, при переходе к другому видео).
+     */
+    void reset();
+
+private:
+    Settings settings; ///< Параметры адаптивной выборки.
+    cv::Mat small_frame; ///< Уменьшенный текущий кадр.
+    cv::Mat small_gray; ///< Уменьшенный текущий кадр в градациях серого.
+    cv::Mat reference; ///< Уменьшенный последний обработанный кадр.
+    cv::Mat difference; ///< Буфер разности кадров.
+    double last_processed = 0; ///< Время последнего обработанного кадра.
+    double dense_until = -1; ///< Время окончания частой выборки.
+    double last_timestamp = 0; ///< Время последнего проверенного кадра.
+    double score = 0; ///< Оценка изменения сцены для последнего проверенного кадра.
+};
+
+#endif
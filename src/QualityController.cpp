@@ -0,0 +1,209 @@
+/**
+ * @file QualityController.cpp
+ * @brief Реализация методов класса QualityController.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include "QualityController.h"
+
+/**
+ * @brief Уровни качества по умолчанию.
+ * Сначала ограничивается число лиц для модели и загрубляется пирамида каскада,
+ * затем пропускаются предсказания и только потом детекции.
+ * @return Уровни от полного качества к самому дешёвому.
+ */
+std::vector<QualityController::Level> QualityController::defaultLevels() {
+    std::vector<Level> levels(5);
+    levels[1].scale_factor = 1.15;
+    levels[1].max_faces = 8;
+
+    levels[2].scale_factor = 1.2;
+    levels[2].min_face_size = cv::Size(120, 120);
+    levels[2].max_faces = 4;
+    levels[2].infer_interval = 2;
+
+    levels[3].scale_factor = 1.3;
+    levels[3].min_face_size = cv::Size(140, 140);
+    levels[3].detect_interval = 2;
+    levels[3].max_faces = 2;
+    levels[3].infer_interval = 2;
+
+    levels[4].scale_factor = 1.4;
+    levels[4].min_face_size = cv::Size(160, 160);
+    levels[4].detect_interval = 3;
+    levels[4].max_faces = 1;
+    levels[4].infer_interval = 3;
+    return levels;
+}
+
+/**
+ * @brief Описывает уровень в виде строки.
+ * @param level Уровень качества.
+ * @return Строка с параметрами уровня.
+ */
+std::string QualityController::describe(const Level& level) {
+    char text[128];
+    std::snprintf(text, sizeof(text), "scale %.2f, min %dpx, detect 1/%d, ", level.scale_factor,
+                  level.min_face_size.width, level.detect_interval);
+    std::string result = text;
+    result += level.max_faces > 0 ? "faces <= " + std::to_string(level.max_faces) : "all faces";
+    result += ", infer 1/" + std::to_string(level.infer_interval);
+    return result;
+}
+
+/**
+ * @brief Конструктор регулятора с параметрами по умолчанию.
+ */
+QualityController::QualityController() : QualityController(Settings()) {}
+
+/**
+ * @brief Конструктор регулятора.
+ * @param settings Параметры регулятора.
+ */
+QualityController::QualityController(const Settings& settings) : settings(settings) {
+    if (this->settings.levels.empty()) {
+        this->settings.levels = defaultLevels();
+    }
+    for (Level& level : this->settings.levels) {
+        level.detect_interval = std::max(1, level.detect_interval);
+        level.infer_interval = std::max(1, level.infer_interval);
+    }
+    level_frames.assign(this->settings.levels.size(), 0);
+    recover_needed = this->settings.recover_frames;
+}
+
+/**
+ * @brief Решает, что делать с очередным кадром текущего уровня.
+ * @return План обработки кадра.
+ */
+QualityController::Plan QualityController::plan() {
+    const Level& current_level = level();
+    Plan result;
+    result.detect = frame_index % current_level.detect_interval == 0;
+    result.infer = result.detect && detection_index % current_level.infer_interval == 0;
+
+    if (result.detect) {
+        detection_index++;
+    }
+    frame_index++;
+    level_frames[current]++;
+    return result;
+}
+
+/**
+ * @brief Учитывает задержку обработки кадра и при необходимости переключает уровень.
+ * @param frame_ms Время обработки кадра, мс.
+ * @return true, если уровень изменился.
+ */
+bool QualityController::record(double frame_ms) {
+    smoothed_ms = has_samples ? smoothed_ms + settings.smoothing * (frame_ms - smoothed_ms) : frame_ms;
+    has_samples = true;
+    frames_since_switch++;
+
+    // Повышение, которое продержалось полный интервал восстановления, считается удачным
+    if (last_switch_up && frames_since_switch == settings.recover_frames) {
+        recover_needed = settings.recover_frames;
+    }
+
+    if (settle_left > 0) {
+        settle_left--;
+        return false;
+    }
+
+    // Понижение качества сразу при превышении цели
+    if (smoothed_ms > settings.target_ms) {
+        headroom_frames = 0;
+        if (current + 1 >= settings.levels.size()) {
+            return false;
+        }
+
+        // Если только что повышенный уровень снова не укладывается в цель, следующая попытка
+        // повышения откладывается вдвое дольше, чтобы регулятор не колебался между уровнями
+        if (last_switch_up && frames_since_switch < settings.recover_frames) {
+            recover_needed = std::min(recover_needed * 2, settings.recover_frames * 8);
+        }
+        switchLevel(current + 1);
+        last_switch_up = false;
+        return true;
+    }
+
+    // Повышение качества только после продолжительного запаса по задержке
+    if (smoothed_ms < settings.target_ms * settings.recover_ratio) {
+        headroom_frames++;
+        if (current > 0 && headroom_frames >= recover_needed) {
+            switchLevel(current - 1);
+            last_switch_up = true;
+            return true;
+        }
+    } else {
+        headroom_frames = 0;
+    }
+    return false;
+}
+
+/**
+ * @brief Переключает уровень и начинает отсчёт кадров нового уровня.
+ * @param index Номер нового уровня.
+ */
+void QualityController::switchLevel(size_t index) {
+    current = index;
+    settle_left = settings.settle_frames;
+    headroom_frames = 0;
+    frames_since_switch = 0;
+    // Первый кадр нового уровня всегда проходит детекцию и предсказание
+    frame_index = 0;
+    detection_index = 0;
+}
+
+/**
+ * @brief Получает текущий уровень.
+ * @return Параметры текущего уровня.
+ */
+const QualityController::Level& QualityController::level() const {
+    return settings.levels[current];
+}
+
+/**
+ * @brief Получает номер текущего уровня.
+ * @return Номер уровня.
+ */
+size_t QualityController::levelIndex() const {
+    return current;
+}
+
+/**
+ * @brief Получает количество уровней.
+ * @return Количество уровней.
+ */
+size_t QualityController::levelCount() const {
+    return settings.levels.size();
+}
+
+/**
+ * @brief Получает сглаженную задержку обработки кадра.
+ * @return Задержка, мс.
+ */
+double QualityController::smoothedLatency() const {
+    return smoothed_ms;
+}
+
+/**
+ * @brief Получает количество кадров, обработанных на уровне.
+ * @param index Номер уровня.
+ * @return Количество кадров.
+ */
+uint64_t QualityController::framesAtLevel(size_t index) const {
+    return index < level_frames.size() ? level_frames[index] : 0;
+}
+
+/**
+ * @brief Описывает текущую рабочую точку.
+ * @return Строка с уровнем, его параметрами и задержкой.
+ */
+std::string QualityController::summary() const {
+    char text[96];
+    std::snprintf(text, sizeof(text), "), latency %.1f ms, target %.1f ms", smoothed_ms, settings.target_ms);
+    return "level " + std::to_string(current) + "/" + std::to_string(settings.levels.size() - 1) +
+           " (" + describe(level()) + text;
+}
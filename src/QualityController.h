@@ -0,0 +1,151 @@
+/**
+ * @file QualityController.h
+ * @brief Объявление класса QualityController.
+ */
+
+#ifndef QUALITYCONTROLLER_H
+#define QUALITYCONTROLLER_H
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class QualityController
+ * @brief Регулятор качества обработки по целевой задержке кадра.
+ * Уровни качества упорядочены от полного (0) к самому дешёвому. Регулятор сглаживает
+ * задержку обработки кадров и сразу понижает качество на один уровень, когда она превышает
+ * цель, а повышает, только когда задержка долго держится заметно ниже цели. После каждого
+ * переключения решения откладываются, пока не накопятся кадры нового уровня.
+ */
+class QualityController {
+
+public:
+    /**
+     * @struct Level
+     * @brief Рабочая точка: параметры детектора и частота детекции и предсказаний.
+     */
+    struct Level {
+        double scale_factor = 1.1; ///< Шаг масштаба пирамиды каскада.
+        cv::Size min_face_size = cv::Size(100, 100); ///< Минимальный размер лица.
+        int detect_interval = 1; ///< Детекция выполняется на каждом N-м кадре.
+        size_t max_faces = 0; ///< Наибольшее число предсказаний на кадр (0 - без ограничения); остальные лица сохраняют прошлые подписи.
+        int infer_interval = 1; ///< Предсказание выполняется на каждой N-й детекции.
+    };
+
+    /**
+     * @struct Settings
+     * @brief Параметры регулятора.
+     */
+    struct Settings {
+        double target_ms = 33.0; ///< Целевая задержка обработки кадра, мс.
+        double recover_ratio = 0.6; ///< Качество повышается, пока задержка ниже этой доли цели.
+        double smoothing = 0.2; ///< Вес нового кадра в экспоненциальном сглаживании задержки.
+        int settle_frames = 10; ///< Кадров после переключения уровня до следующего решения.
+        int recover_frames = 60; ///< Кадров с запасом подряд до повышения качества (удваивается после неудачного повышения).
+        std::vector<Level> levels; ///< Уровни от полного качества к самому дешёвому (пустой - defaultLevels).
+    };
+
+    /**
+     * @struct Plan
+     * @brief Что нужно сделать с очередным кадром.
+     */
+    struct Plan {
+        bool detect = true; ///< Искать лица на кадре.
+        bool infer = true; ///< Выполнить предсказание для найденных лиц.
+    };
+
+    /**
+     * @brief Уровни качества по умолчанию. Нулевой уровень совпадает с настройками FaceDetector.
+     * @return Уровни от полного качества к самому дешёвому.
+     */
+    static std::vector<Level> defaultLevels();
+
+    /**
+     * @brief Описывает уровень в виде строки для журнала и метрик.
+     * @param level Уровень качества.
+     * @return Строка вида "scale 1.20, min 120px, detect 1/2, faces <= 4, infer 1/1".
+     */
+    static std::string describe(const Level& level);
+
+    /**
+     * @brief Конструктор регулятора с параметрами по умолчанию.
+     */
+    QualityController();
+
+    /**
+     * @brief Конструктор регулятора.
+     * @param settings Параметры регулятора.
+     */
+    explicit QualityController(const Settings& settings);
+
+    /**
+     * @brief Решает, что делать с очередным кадром текущего уровня. Вызывается один раз на кадр.
+     * @return План обработки кадра.
+     */
+    Plan plan();
+
+    /**
+     * @brief Учитывает задержку обработки кадра и при необходимости переключает уровень.
+     * @param frame_ms Время обработки кадра, мс.
+     * @return true, если уровень изменился.
+     */
+    bool record(double frame_ms);
+
+    /**
+     * @brief Получает текущий уровень.
+     * @return Параметры текущего уровня.
+     */
+    const Level& level() const;
+
+    /**
+     * @brief Получает номер текущего уровня (0 - полное качество).
+     * @return Номер уровня.
+     */
+    size_t levelIndex() const;
+
+    /**
+     * @brief Получает количество уровней.
+     * @return Количество уровней.
+     */
+    size_t levelCount() const;
+
+    /**
+     * @brief Получает сглаженную задержку обработки кадра.
+     * @return Задержка, мс.
+     */
+    double smoothedLatency() const;
+
+    /**
+     * @brief Получает количество кадров, обработанных на уровне.
+     * @param index Номер уровня.
+     * @return Количество кадров.
+     */
+    uint64_t framesAtLevel(size_t index) const;
+
+    /**
+     * @brief Описывает текущую рабочую точку.
+     * @return Строка вида "level 2/4 (...), latency 30.1 ms, target 33.0 ms".
+     */
+    std::string summary() const;
+
+private:
+    void switchLevel(size_t index);
+
+    Settings settings; ///< Параметры регулятора.
+    size_t current = 0; ///< Номер текущего уровня.
+    double smoothed_ms = 0.0; ///< Сглаженная задержка кадра, мс.
+    bool has_samples = false; ///< Получена хотя бы одна задержка.
+    int settle_left = 0; ///< Кадров до следующего решения.
+    int headroom_frames = 0; ///< Кадров подряд с запасом по задержке.
+    int recover_needed = 0; ///< Кадров с запасом, нужных для следующего повышения качества.
+    int frames_since_switch = 0; ///< Кадров с последнего переключения уровня.
+    bool last_switch_up = false; ///< Последнее переключение повысило качество.
+    uint64_t frame_index = 0; ///< Номер кадра с момента переключения уровня.
+    uint64_t detection_index = 0; ///< Номер детекции с момента переключения уровня.
+    std::vector<uint64_t> level_frames; ///< Количество кадров на каждом уровне.
+};
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file ReplaySource.cpp
+ * @brief Реализация методов класса ReplaySource.
+ */
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "ReplaySource.h"
+
+/**
+ * @brief Наибольший размер данных одного кадра, который принимается из записи.
+ */
+static const uint64_t MAX_RECORDED_FRAME_SIZE = 1ull << 30;
+
+/**
+ * @brief Конструктор открывает запись, проверяет заголовок и подсчитывает кадры.
+ * @param filename Путь к файлу записи.
+ * @param speed Скорость воспроизведения.
+ * @param preload Прочитать и декодировать все кадры заранее.
+ */
+ReplaySource::ReplaySource(const std::string& filename, Speed speed, bool preload)
+    : input(filename, std::ios::binary), speed(speed) {
+    RecordingHeader header;
+    if (!input.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, RECORDING_MAGIC, sizeof(header.magic)) != 0 || header.version != RECORDING_VERSION) {
+        std::cerr << "Unable to open recording " << filename << std::endl;
+        return;
+    }
+    opened = true;
+
+    // Оборванная запись (frame_count = 0) тоже воспроизводится до последнего целого кадра
+    scanRecording();
+
+    if (preload) {
+        cv::Mat frame;
+        double frame_timestamp = 0.0;
+        while (readRecord(frame, frame_timestamp)) {
+            preloaded_frames.push_back(frame.clone());
+            preloaded_timestamps.push_back(frame_timestamp);
+        }
+        input.close();
+    }
+}
+
+/**
+ * @brief Проходит по заголовкам кадров без чтения данных: количество кадров, длительность и размер кадра.
+ * После прохода файл снова указывает на первый кадр.
+ */
+void ReplaySource::scanRecording() {
+    std::streampos data_start = input.tellg();
+    input.seekg(0, std::ios::end);
+    std::streamoff file_size = input.tellg() - data_start;
+    input.seekg(data_start);
+
+    std::streamoff offset = 0;
+    RecordedFrameHeader header;
+    while (offset + static_cast<std::streamoff>(sizeof(header)) <= file_size &&
+           input.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        offset += sizeof(header) + header.size;
+        if (header.size > MAX_RECORDED_FRAME_SIZE || offset > file_size) {
+            break;
+        }
+        if (frame_count == 0) {
+            first_timestamp = header.timestamp;
+            frame_size = cv::Size(header.cols, header.rows);
+        }
+        duration = header.timestamp - first_timestamp;
+        frame_count++;
+        input.seekg(header.size, std::ios::cur);
+    }
+
+    input.clear();
+    input.seekg(data_start);
+}
+
+/**
+ * @brief Читает и декодирует следующий кадр записи.
+ * @param frame Кадр; буфер переиспользуется для несжатых кадров того же размера.
+ * @param frame_timestamp Время кадра, с.
+ * @return false, если кадры закончились или запись повреждена.
+ */
+bool ReplaySource::readRecord(cv::Mat& frame, double& frame_timestamp) {
+    RecordedFrameHeader header;
+    if (!input.is_open() || !input.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.rows <= 0 || header.cols <= 0 || header.size > MAX_RECORDED_FRAME_SIZE) {
+        return false;
+    }
+
+    if (header.codec == RECORDING_RAW) {
+        // Несжатый кадр читается прямо в буфер кадра без промежуточной копии
+        frame.create(header.rows, header.cols, header.type);
+        if (!frame.isContinuous()) {
+            frame = cv::Mat(header.rows, header.cols, header.type);
+        }
+        if (header.size != frame.total() * frame.elemSize() ||
+            !input.read(reinterpret_cast<char*>(frame.data), header.size)) {
+            return false;
+        }
+    } else if (header.codec == RECORDING_PNG) {
+        encoded.resize(header.size);
+        if (!input.read(reinterpret_cast<char*>(encoded.data()), header.size)) {
+            return false;
+        }
+        frame = cv::imdecode(encoded, cv::IMREAD_UNCHANGED);
+        if (frame.empty() || frame.type() != header.type) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    frame_timestamp = header.timestamp;
+    return true;
+}
+
+/**
+ * @brief Проверяет, открыт ли источник.
+ * @return true, если заголовок записи корректен.
+ */
+bool ReplaySource::isOpened() const {
+    return opened;
+}
+
+/**
+ * @brief Выдаёт следующий кадр записи; при записанной скорости ждёт момента кадра.
+ * @param frame Кадр. Предварительно загруженный кадр выдаётся без копирования.
+ * @return false, если кадры закончились.
+ */
+bool ReplaySource::read(cv::Mat& frame) {
+    if (!opened) {
+        return false;
+    }
+
+    double frame_timestamp = 0.0;
+    if (!preloaded_frames.empty() || !input.is_open()) {
+        if (next_frame >= preloaded_frames.size()) {
+            return false;
+        }
+        frame = preloaded_frames[next_frame];
+        frame_timestamp = preloaded_timestamps[next_frame];
+    } else if (!readRecord(frame, frame_timestamp)) {
+        return false;
+    }
+
+    if (next_frame == 0) {
+        replay_start = std::chrono::steady_clock::now();
+        first_timestamp = frame_timestamp;
+    } else if (speed == RECORDED_SPEED) {
+        std::this_thread::sleep_until(replay_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(frame_timestamp - first_timestamp)));
+    }
+
+    last_timestamp = frame_timestamp;
+    next_frame++;
+    return true;
+}
+
+/**
+ * @brief Получает время последнего выданного кадра.
+ * @return Записанное время кадра, с.
+ */
+double ReplaySource::timestamp() const {
+    return last_timestamp;
+}
+
+/**
+ * @brief Получает свойство записи.
+ * @param property Идентификатор свойства.
+ * @return Значение свойства или 0.
+ */
+double ReplaySource::get(int property) const {
+    switch (property) {
+        case cv::CAP_PROP_FRAME_WIDTH: return frame_size.width;
+        case cv::CAP_PROP_FRAME_HEIGHT: return frame_size.height;
+        case cv::CAP_PROP_FRAME_COUNT: return static_cast<double>(frame_count);
+        case cv::CAP_PROP_POS_FRAMES: return static_cast<double>(next_frame);
+        case cv::CAP_PROP_FPS: return frame_count > 1 && duration > 0 ? (frame_count - 1) / duration : 0.0;
+        default: return 0.0;
+    }
+}
+
+/**
+ * @brief Получает количество кадров, выданных с момента открытия.
+ * @return Количество кадров.
+ */
+uint64_t ReplaySource::framesRead() const {
+    return next_frame;
+}
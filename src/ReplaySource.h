@@ -0,0 +1,82 @@
+/**
+ * @file ReplaySource.h
+ * @brief Объявление класса ReplaySource.
+ */
+
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include <opencv2/core.hpp>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "FrameRecorder.h"
+#include "FrameSource.h"
+
+/**
+ * @class ReplaySource
+ * @brief Источник кадров, воспроизводящий запись FrameRecorder.
+ * Кадры и их время в точности повторяют записанный поток, поэтому изменения конвейера
+ * можно сравнивать на одинаковой нагрузке. Воспроизведение идёт либо с записанной скоростью
+ * (read ждёт момента кадра относительно первого кадра), либо так быстро, как читает конвейер.
+ */
+class ReplaySource : public FrameSource {
+
+public:
+    /**
+     * @enum Speed
+     * @brief Скорость воспроизведения.
+     */
+    enum Speed {
+        RECORDED_SPEED, ///< Кадры выдаются не раньше, чем в записанном потоке.
+        MAX_SPEED ///< Кадры выдаются без ожидания.
+    };
+
+    /**
+     * @brief Конструктор открывает запись.
+     * @param filename Путь к файлу записи.
+     * @param speed Скорость воспроизведения.
+     * @param preload Прочитать и декодировать все кадры заранее, чтобы чтение файла
+     * и распаковка PNG не попадали в измерения конвейера.
+     */
+    explicit ReplaySource(const std::string& filename, Speed speed = RECORDED_SPEED, bool preload = false);
+
+    bool isOpened() const override;
+    bool read(cv::Mat& frame) override;
+    double timestamp() const override;
+
+    /**
+     * @brief Получает свойство записи: размер кадра, количество кадров и средняя частота кадров.
+     * @param property Идентификатор свойства.
+     * @return Значение свойства или 0.
+     */
+    double get(int property) const override;
+
+    /**
+     * @brief Получает количество кадров, выданных с момента открытия.
+     * @return Количество кадров.
+     */
+    uint64_t framesRead() const;
+
+private:
+    bool readRecord(cv::Mat& frame, double& frame_timestamp);
+    void scanRecording();
+
+    std::ifstream input; ///< Файл записи.
+    bool opened = false; ///< Заголовок записи прочитан и корректен.
+    Speed speed; ///< Скорость воспроизведения.
+    std::vector<cv::Mat> preloaded_frames; ///< Декодированные кадры при предварительной загрузке.
+    std::vector<double> preloaded_timestamps; ///< Время предварительно загруженных кадров.
+    std::vector<uchar> encoded; ///< Буфер сжатого кадра.
+    uint64_t frame_count = 0; ///< Количество кадров в записи.
+    double duration = 0.0; ///< Время между первым и последним кадром, с.
+    cv::Size frame_size; ///< Размер первого кадра.
+    uint64_t next_frame = 0; ///< Номер следующего кадра.
+    double first_timestamp = 0.0; ///< Время первого кадра записи.
+    double last_timestamp = 0.0; ///< Время последнего выданного кадра.
+    std::chrono::steady_clock::time_point replay_start; ///< Момент выдачи первого кадра.
+};
+
+#endif
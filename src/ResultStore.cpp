@@ -0,0 +1,502 @@
+/**
+ * @file ResultStore.cpp
+ * @brief Реализация методов классов ResultStoreWriter и ResultStore.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "ResultStore.h"
+
+static_assert(sizeof(ResultStoreHeader) == 64, "ResultStoreHeader must be 64 bytes");
+
+/**
+ * @brief Размер одной записи во всех столбцах блока, байт.
+ * @param class_count Количество классов.
+ * @return Время, номер кадра, рамка, класс и вероятности классов.
+ */
+static size_t recordBytes(size_t class_count) {
+    return sizeof(double) + sizeof(uint32_t) + 4 * sizeof(int16_t) + sizeof(int8_t) + class_count * sizeof(float);
+}
+
+/**
+ * @brief Смещения столбцов внутри блока (C - ёмкость блока): время с 0, номера кадров с 8C,
+ * рамки с 12C, классы с 20C, вероятности класса k с 21C + 4Ck. Ёмкость кратна 8,
+ * поэтому все столбцы выровнены по размеру своих элементов.
+ */
+static size_t frameColumn(size_t capacity) { return 8 * capacity; }
+static size_t faceColumn(size_t capacity) { return 12 * capacity; }
+static size_t classColumn(size_t capacity) { return 20 * capacity; }
+static size_t scoreColumn(size_t capacity, int class_id) { return (21 + 4 * static_cast<size_t>(class_id)) * capacity; }
+
+/**
+ * @brief Смещение блока в файле.
+ * @param block Номер блока.
+ * @param block_size Размер блока.
+ * @return Смещение от начала файла.
+ */
+static off_t blockOffset(uint64_t block, size_t block_size) {
+    return static_cast<off_t>(sizeof(ResultStoreHeader) + block * block_size);
+}
+
+/**
+ * @brief Записывает буфер целиком по смещению.
+ * @return true, если записаны все байты.
+ */
+static bool writeAt(int fd, const void* data, size_t size, off_t offset) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, offset);
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+/**
+ * @brief Читает буфер целиком по смещению.
+ * @return true, если прочитаны все байты.
+ */
+static bool readAt(int fd, void* data, size_t size, off_t offset) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t count = pread(fd, bytes, size, offset);
+        if (count <= 0) {
+            return false;
+        }
+        bytes += count;
+        size -= count;
+        offset += count;
+    }
+    return true;
+}
+
+/**
+ * @brief Деструктор записывает текущий блок и закрывает файл.
+ */
+ResultStoreWriter::~ResultStoreWriter() {
+    close();
+}
+
+/**
+ * @brief Открывает хранилище для дописывания или создаёт новое.
+ * @param filename Путь к файлу хранилища.
+ * @param class_count Количество классов.
+ * @param resume_from Время, начиная с которого существующие записи отбрасываются.
+ * @return true, если хранилище открыто.
+ */
+bool ResultStoreWriter::open(const std::string& filename, size_t class_count, double resume_from) {
+    close();
+
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Unable to open result store " << filename << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+
+    if (info.st_size < static_cast<off_t>(sizeof(ResultStoreHeader))) {
+        // Новое хранилище
+        header = {};
+        std::memcpy(header.magic, RESULT_STORE_MAGIC, sizeof(header.magic));
+        header.version = RESULT_STORE_VERSION;
+        header.class_count = static_cast<uint32_t>(class_count);
+        header.block_capacity = RESULT_STORE_BLOCK_CAPACITY;
+        if (!writeAt(fd, &header, sizeof(header), 0)) {
+            close();
+            return false;
+        }
+    } else if (!readAt(fd, &header, sizeof(header), 0) ||
+               std::memcmp(header.magic, RESULT_STORE_MAGIC, sizeof(header.magic)) != 0 ||
+               header.version != RESULT_STORE_VERSION || header.class_count != class_count ||
+               header.block_capacity == 0 || header.block_capacity % 8 != 0) {
+        std::cerr << "Result store " << filename << " has unsupported format" << std::endl;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    resizeBlock();
+    const uint32_t capacity = header.block_capacity;
+    record_count = header.record_count;
+
+    // Отбрасывание записей после точки возобновления: двоичный поиск по столбцу времени на диске
+    auto timestampAt = [&](uint64_t index) {
+        double value = 0.0;
+        readAt(fd, &value, sizeof(value), blockOffset(index / capacity, block.size()) + (index % capacity) * sizeof(double));
+        return value;
+    };
+    uint64_t low = 0;
+    uint64_t high = record_count;
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        if (timestampAt(middle) < resume_from) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    bool truncated = low != record_count;
+    record_count = low;
+    last_timestamp = record_count > 0 ? timestampAt(record_count - 1) : -std::numeric_limits<double>::infinity();
+
+    // Незаполненный последний блок продолжается в памяти
+    if (record_count % capacity != 0 &&
+        !readAt(fd, block.data(), block.size(), blockOffset(record_count / capacity, block.size()))) {
+        close();
+        return false;
+    }
+
+    if (truncated) {
+        header.record_count = record_count;
+        if (!writeAt(fd, &header, sizeof(header), 0)) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Выделяет пустой буфер блока по параметрам заголовка.
+ */
+void ResultStoreWriter::resizeBlock() {
+    block.assign(header.block_capacity * recordBytes(header.class_count), 0);
+    block_dirty = false;
+}
+
+/**
+ * @brief Добавляет предсказание для одного лица.
+ * @param timestamp Время кадра, с.
+ * @param frame_number Номер кадра.
+ * @param face Рамка лица.
+ * @param prediction Предсказание с вероятностями всех классов.
+ * @return false, если хранилище закрыто, время идёт назад или запись не удалась.
+ */
+bool ResultStoreWriter::append(double timestamp, uint32_t frame_number, const cv::Rect& face,
+                               const EmotionPrediction& prediction) {
+    if (fd < 0 || timestamp < last_timestamp) {
+        return false;
+    }
+
+    const size_t capacity = header.block_capacity;
+    const size_t slot = record_count % capacity;
+    char* data = block.data();
+
+    reinterpret_cast<double*>(data)[slot] = timestamp;
+    reinterpret_cast<uint32_t*>(data + frameColumn(capacity))[slot] = frame_number;
+    int16_t* box = reinterpret_cast<int16_t*>(data + faceColumn(capacity)) + 4 * slot;
+    box[0] = static_cast<int16_t>(std::min(face.x, 32767));
+    box[1] = static_cast<int16_t>(std::min(face.y, 32767));
+    box[2] = static_cast<int16_t>(std::min(face.width, 32767));
+    box[3] = static_cast<int16_t>(std::min(face.height, 32767));
+    reinterpret_cast<int8_t*>(data + classColumn(capacity))[slot] = static_cast<int8_t>(prediction.class_id);
+    for (uint32_t k = 0; k < header.class_count; k++) {
+        float value = k < prediction.scores.size() ? prediction.scores[k] : 0.0f;
+        reinterpret_cast<float*>(data + scoreColumn(capacity, k))[slot] = value;
+    }
+
+    record_count++;
+    last_timestamp = timestamp;
+    block_dirty = true;
+
+    // Заполненный блок сразу уходит на диск, следующий начинается с пустого буфера
+    if (slot + 1 == capacity) {
+        if (!writeBlock()) {
+            return false;
+        }
+        std::fill(block.begin(), block.end(), 0);
+    }
+    return true;
+}
+
+/**
+ * @brief Записывает текущий блок, затем количество записей в заголовке.
+ * @return true, если данные записаны.
+ */
+bool ResultStoreWriter::writeBlock() {
+    if (!block_dirty) {
+        return true;
+    }
+
+    // Заголовок обновляется только после данных, поэтому читатели никогда не видят незаписанные записи
+    uint64_t block_index = (record_count - 1) / header.block_capacity;
+    header.record_count = record_count;
+    if (!writeAt(fd, block.data(), block.size(), blockOffset(block_index, block.size())) ||
+        !writeAt(fd, &header, sizeof(header), 0)) {
+        return false;
+    }
+    block_dirty = false;
+    return true;
+}
+
+/**
+ * @brief Записывает текущий блок и количество записей на диск.
+ * @return true, если данные записаны.
+ */
+bool ResultStoreWriter::flush() {
+    return fd >= 0 && writeBlock() && fdatasync(fd) == 0;
+}
+
+/**
+ * @brief Записывает текущий блок и закрывает файл.
+ * @return true, если данные записаны.
+ */
+bool ResultStoreWriter::close() {
+    if (fd < 0) {
+        return false;
+    }
+    bool written = writeBlock();
+    written = ::close(fd) == 0 && written;
+    fd = -1;
+    return written;
+}
+
+/**
+ * @brief Получает количество записей.
+ * @return Количество записей.
+ */
+uint64_t ResultStoreWriter::size() const {
+    return record_count;
+}
+
+/**
+ * @brief Деструктор снимает отображение файла.
+ */
+ResultStore::~ResultStore() {
+    close();
+}
+
+/**
+ * @brief Отображает хранилище в память и строит индекс времени блоков.
+ * @param filename Путь к файлу хранилища.
+ * @return true, если хранилище корректно.
+ */
+bool ResultStore::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Unable to open result store " << filename << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(ResultStoreHeader))) {
+        std::cerr << "Result store " << filename << " is truncated" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Unable to map result store " << filename << std::endl;
+        return false;
+    }
+    mapping = mapped;
+    mapping_size = info.st_size;
+
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, RESULT_STORE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != RESULT_STORE_VERSION || header.block_capacity == 0 || header.block_capacity % 8 != 0 ||
+        header.class_count == 0 || header.class_count > 127) {
+        std::cerr << "Result store " << filename << " has unsupported format" << std::endl;
+        close();
+        return false;
+    }
+
+    block_size = header.block_capacity * recordBytes(header.class_count);
+    uint64_t block_count = (header.record_count + header.block_capacity - 1) / header.block_capacity;
+    if (sizeof(ResultStoreHeader) + block_count * block_size > mapping_size) {
+        std::cerr << "Result store " << filename << " is truncated" << std::endl;
+        close();
+        return false;
+    }
+
+    // Индекс времени: первое время каждого блока; читается по одной странице на блок
+    for (uint64_t block = 0; block < block_count; block++) {
+        block_start_times.push_back(timestamp(block * header.block_capacity));
+    }
+    return true;
+}
+
+/**
+ * @brief Снимает отображение файла.
+ */
+void ResultStore::close() {
+    if (mapping != nullptr) {
+        munmap(mapping, mapping_size);
+    }
+    mapping = nullptr;
+    mapping_size = 0;
+    header = {};
+    block_size = 0;
+    block_start_times.clear();
+}
+
+/**
+ * @brief Проверяет, открыто ли хранилище.
+ * @return true, если хранилище открыто.
+ */
+bool ResultStore::isOpen() const {
+    return mapping != nullptr;
+}
+
+/**
+ * @brief Получает количество записей.
+ * @return Количество записей.
+ */
+uint64_t ResultStore::size() const {
+    return header.record_count;
+}
+
+/**
+ * @brief Получает количество классов.
+ * @return Количество классов.
+ */
+size_t ResultStore::classCount() const {
+    return header.class_count;
+}
+
+/**
+ * @brief Находит блок записи.
+ * @param index Номер записи.
+ * @param offset Номер записи внутри блока.
+ * @return Начало блока в отображённой памяти.
+ */
+const char* ResultStore::blockData(uint64_t index, uint64_t& offset) const {
+    offset = index % header.block_capacity;
+    return static_cast<const char*>(mapping) + blockOffset(index / header.block_capacity, block_size);
+}
+
+/**
+ * @brief Получает время записи.
+ * @param index Номер записи.
+ * @return Время кадра, с.
+ */
+double ResultStore::timestamp(uint64_t index) const {
+    uint64_t offset = 0;
+    const char* data = blockData(index, offset);
+    return reinterpret_cast<const double*>(data)[offset];
+}
+
+/**
+ * @brief Получает номер кадра записи.
+ * @param index Номер записи.
+ * @return Номер кадра.
+ */
+uint32_t ResultStore::frameNumber(uint64_t index) const {
+    uint64_t offset = 0;
+    const char* data = blockData(index, offset);
+    return reinterpret_cast<const uint32_t*>(data + frameColumn(header.block_capacity))[offset];
+}
+
+/**
+ * @brief Получает рамку лица записи.
+ * @param index Номер записи.
+ * @return Рамка лица.
+ */
+cv::Rect ResultStore::face(uint64_t index) const {
+    uint64_t offset = 0;
+    const char* data = blockData(index, offset);
+    const int16_t* box = reinterpret_cast<const int16_t*>(data + faceColumn(header.block_capacity)) + 4 * offset;
+    return cv::Rect(box[0], box[1], box[2], box[3]);
+}
+
+/**
+ * @brief Получает класс записи.
+ * @param index Номер записи.
+ * @return ID класса.
+ */
+int ResultStore::classId(uint64_t index) const {
+    uint64_t offset = 0;
+    const char* data = blockData(index, offset);
+    return reinterpret_cast<const int8_t*>(data + classColumn(header.block_capacity))[offset];
+}
+
+/**
+ * @brief Получает вероятность класса для записи.
+ * @param index Номер записи.
+ * @param class_id ID класса.
+ * @return Вероятность.
+ */
+float ResultStore::score(uint64_t index, int class_id) const {
+    uint64_t offset = 0;
+    const char* data = blockData(index, offset);
+    return reinterpret_cast<const float*>(data + scoreColumn(header.block_capacity, class_id))[offset];
+}
+
+/**
+ * @brief Находит первую запись со временем не меньше заданного.
+ * @param time Время, с.
+ * @return Номер записи или size().
+ */
+uint64_t ResultStore::lowerBound(double time) const {
+    // Блок, в котором может начинаться диапазон, - последний блок, начинающийся раньше time
+    size_t next_block = std::lower_bound(block_start_times.begin(), block_start_times.end(), time) -
+                        block_start_times.begin();
+    if (next_block == 0) {
+        return 0;
+    }
+
+    uint64_t first = static_cast<uint64_t>(next_block - 1) * header.block_capacity;
+    uint64_t count = std::min<uint64_t>(header.block_capacity, header.record_count - first);
+    uint64_t offset = 0;
+    const double* times = reinterpret_cast<const double*>(blockData(first, offset));
+    return first + (std::lower_bound(times, times + count, time) - times);
+}
+
+/**
+ * @brief Считает записи каждого класса в интервале времени.
+ * @param from Начало интервала, с.
+ * @param to Конец интервала, с.
+ * @return Количество записей по классам.
+ */
+std::vector<uint64_t> ResultStore::distribution(double from, double to) const {
+    std::vector<uint64_t> counts(header.class_count, 0);
+    uint64_t end = lowerBound(to);
+    for (uint64_t index = lowerBound(from); index < end; index++) {
+        int class_id = classId(index);
+        if (class_id >= 0 && class_id < static_cast<int>(counts.size())) {
+            counts[class_id]++;
+        }
+    }
+    return counts;
+}
+
+/**
+ * @brief Находит записи интервала, в которых вероятность класса больше порога.
+ * @param class_id ID класса.
+ * @param threshold Порог вероятности.
+ * @param from Начало интервала, с.
+ * @param to Конец интервала, с.
+ * @return Номера записей.
+ */
+std::vector<uint64_t> ResultStore::findAbove(int class_id, float threshold, double from, double to) const {
+    std::vector<uint64_t> matches;
+    if (class_id < 0 || class_id >= static_cast<int>(header.class_count)) {
+        return matches;
+    }
+
+    uint64_t end = lowerBound(to);
+    for (uint64_t index = lowerBound(from); index < end; index++) {
+        if (score(index, class_id) > threshold) {
+            matches.push_back(index);
+        }
+    }
+    return matches;
+}
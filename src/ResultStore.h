@@ -0,0 +1,251 @@
+/**
+ * @file ResultStore.h
+ * @brief Объявление классов ResultStoreWriter и ResultStore и формата хранилища результатов.
+ */
+
+#ifndef RESULTSTORE_H
+#define RESULTSTORE_H
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Model.h"
+
+/**
+ * @brief Сигнатура файла хранилища результатов.
+ */
+static const char RESULT_STORE_MAGIC[8] = {'E', 'M', 'O', 'R', 'E', 'S', '\0', '\0'};
+
+/**
+ * @brief Версия формата хранилища результатов.
+ */
+static const uint32_t RESULT_STORE_VERSION = 1;
+
+/**
+ * @brief Количество записей в блоке хранилища по умолчанию.
+ */
+static const uint32_t RESULT_STORE_BLOCK_CAPACITY = 4096;
+
+/**
+ * @struct ResultStoreHeader
+ * @brief Заголовок хранилища результатов (порядок байтов хоста, 64 байта).
+ * За заголовком следуют блоки одинакового размера. Блок хранит block_capacity записей по столбцам:
+ * время (double), номер кадра (uint32), рамка лица (4 x int16), класс (int8),
+ * затем вероятности каждого класса отдельным столбцом (float).
+ */
+struct ResultStoreHeader {
+    char magic[8]; ///< RESULT_STORE_MAGIC.
+    uint32_t version; ///< RESULT_STORE_VERSION.
+    uint32_t class_count; ///< Количество классов (столбцов вероятностей).
+    uint32_t block_capacity; ///< Количество записей в блоке (кратно 8).
+    uint32_t reserved; ///< Не используется.
+    uint64_t record_count; ///< Количество записей, целиком записанных на диск.
+    char padding[32]; ///< Дополнение до 64 байт.
+};
+
+/**
+ * @class ResultStoreWriter
+ * @brief Дописывает предсказания по лицам в хранилище результатов в порядке времени кадров.
+ * Текущий блок собирается в памяти и записывается целиком при заполнении и при flush,
+ * после чего в заголовке обновляется количество записей. Поэтому после аварийного завершения
+ * хранилище содержит все записи до последнего flush, а незавершённый хвост не виден читателям.
+ */
+class ResultStoreWriter {
+
+public:
+    /**
+     * @brief Конструктор закрытого хранилища.
+     */
+    ResultStoreWriter() {};
+
+    /**
+     * @brief Деструктор записывает текущий блок и закрывает файл.
+     */
+    ~ResultStoreWriter();
+
+    ResultStoreWriter(const ResultStoreWriter&) = delete;
+    ResultStoreWriter& operator=(const ResultStoreWriter&) = delete;
+
+    /**
+     * @brief Открывает хранилище для дописывания или создаёт новое.
+     * Записи со временем не меньше resume_from отбрасываются: при возобновлении обработки
+     * с контрольной точки кадры после неё будут записаны заново.
+     * @param filename Путь к файлу хранилища.
+     * @param class_count Количество классов.
+     * @param resume_from Время, начиная с которого существующие записи отбрасываются.
+     * @return true, если хранилище открыто.
+     */
+    bool open(const std::string& filename, size_t class_count,
+              double resume_from = std::numeric_limits<double>::infinity());
+
+    /**
+     * @brief Добавляет предсказание для одного лица.
+     * @param timestamp Время кадра, с; не меньше времени предыдущей записи.
+     * @param frame_number Номер кадра.
+     * @param face Рамка лица.
+     * @param prediction Предсказание с вероятностями всех классов.
+     * @return false, если хранилище закрыто, время идёт назад или запись не удалась.
+     */
+    bool append(double timestamp, uint32_t frame_number, const cv::Rect& face, const EmotionPrediction& prediction);
+
+    /**
+     * @brief Записывает текущий блок и количество записей на диск (контрольная точка).
+     * @return true, если данные записаны.
+     */
+    bool flush();
+
+    /**
+     * @brief Записывает текущий блок и закрывает файл.
+     * @return true, если данные записаны.
+     */
+    bool close();
+
+    /**
+     * @brief Получает количество записей, включая ещё не записанные на диск.
+     * @return Количество записей.
+     */
+    uint64_t size() const;
+
+private:
+    bool writeBlock();
+    void resizeBlock();
+
+    int fd = -1; ///< Дескриптор файла хранилища.
+    ResultStoreHeader header = {}; ///< Заголовок хранилища.
+    uint64_t record_count = 0; ///< Количество записей.
+    double last_timestamp = -std::numeric_limits<double>::infinity(); ///< Время последней записи.
+    std::vector<char> block; ///< Текущий блок в формате файла.
+    bool block_dirty = false; ///< Текущий блок изменён после записи на диск.
+};
+
+/**
+ * @class ResultStore
+ * @brief Хранилище результатов, отображённое в память только для чтения.
+ * Записи упорядочены по времени, поэтому диапазон времени находится двоичным поиском:
+ * сначала по индексу первых времён блоков, построенному при открытии, затем внутри блока.
+ * Запросы читают только нужные столбцы нужных блоков, а не весь файл.
+ */
+class ResultStore {
+
+public:
+    /**
+     * @brief Конструктор закрытого хранилища.
+     */
+    ResultStore() {};
+
+    /**
+     * @brief Деструктор снимает отображение файла.
+     */
+    ~ResultStore();
+
+    ResultStore(const ResultStore&) = delete;
+    ResultStore& operator=(const ResultStore&) = delete;
+
+    /**
+     * @brief Отображает хранилище в память и строит индекс времени блоков.
+     * @param filename Путь к файлу хранилища.
+     * @return true, если хранилище корректно.
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Снимает отображение файла.
+     */
+    void close();
+
+    /**
+     * @brief Проверяет, открыто ли хранилище.
+     * @return true, если хранилище открыто.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Получает количество записей.
+     * @return Количество записей.
+     */
+    uint64_t size() const;
+
+    /**
+     * @brief Получает количество классов.
+     * @return Количество классов.
+     */
+    size_t classCount() const;
+
+    /**
+     * @brief Получает время записи.
+     * @param index Номер записи.
+     * @return Время кадра, с.
+     */
+    double timestamp(uint64_t index) const;
+
+    /**
+     * @brief Получает номер кадра записи.
+     * @param index Номер записи.
+     * @return Номер кадра.
+     */
+    uint32_t frameNumber(uint64_t index) const;
+
+    /**
+     * @brief Получает рамку лица записи.
+     * @param index Номер записи.
+     * @return Рамка лица.
+     */
+    cv::Rect face(uint64_t index) const;
+
+    /**
+     * @brief Получает класс записи.
+     * @param index Номер записи.
+     * @return ID класса с наибольшей вероятностью.
+     */
+    int classId(uint64_t index) const;
+
+    /**
+     * @brief Получает вероятность класса для записи.
+     * @param index Номер записи.
+     * @param class_id ID класса.
+     * @return Вероятность.
+     */
+    float score(uint64_t index, int class_id) const;
+
+    /**
+     * @brief Находит первую запись со временем не меньше заданного.
+     * @param time Время, с.
+     * @return Номер записи или size(), если таких записей нет.
+     */
+    uint64_t lowerBound(double time) const;
+
+    /**
+     * @brief Считает записи каждого класса в интервале времени [from, to).
+     * @param from Начало интервала, с.
+     * @param to Конец интервала, с.
+     * @return Количество записей по классам.
+     */
+    std::vector<uint64_t> distribution(double from, double to) const;
+
+    /**
+     * @brief Находит записи интервала [from, to), в которых вероятность класса больше порога.
+     * Читается только столбец вероятностей этого класса.
+     * @param class_id ID класса.
+     * @param threshold Порог вероятности.
+     * @param from Начало интервала, с.
+     * @param to Конец интервала, с.
+     * @return Номера записей в порядке времени.
+     */
+    std::vector<uint64_t> findAbove(int class_id, float threshold,
+                                    double from = -std::numeric_limits<double>::infinity(),
+                                    double to = std::numeric_limits<double>::infinity()) const;
+
+private:
+    const char* blockData(uint64_t index, uint64_t& offset) const;
+
+    void* mapping = nullptr; ///< Отображённая память.
+    size_t mapping_size = 0; ///< Размер отображённой памяти.
+    ResultStoreHeader header = {}; ///< Заголовок хранилища.
+    size_t block_size = 0; ///< Размер блока, байт.
+    std::vector<double> block_start_times; ///< Время первой записи каждого блока.
+};
+
+#endif
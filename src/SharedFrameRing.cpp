@@ -0,0 +1,401 @@
+/**
+ * @file SharedFrameRing.cpp
+ * @brief Реализация методов класса SharedFrameRing.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include "SharedFrameRing.h"
+
+/**
+ * @brief Сигнатура кольца в разделяемой памяти.
+ */
+static const char RING_MAGIC[8] = {'E', 'M', 'O', 'R', 'I', 'N', 'G', '\0'};
+/**
+ * @brief Версия формата кольца.
+ */
+static const uint32_t RING_VERSION = 1;
+/**
+ * @brief Выравнивание заголовков и данных слотов (размер строки кэша).
+ */
+static const size_t RING_ALIGNMENT = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared memory needs lock-free 64-bit atomics");
+static_assert(std::atomic<double>::is_always_lock_free, "shared memory needs lock-free double atomics");
+
+/**
+ * @struct SharedFrameRing::RingHeader
+ * @brief Заголовок кольца в начале разделяемой памяти.
+ */
+struct SharedFrameRing::RingHeader {
+    char magic[8]; ///< Сигнатура "EMORING\0".
+    uint32_t version; ///< Версия формата.
+    uint32_t slot_count; ///< Количество слотов.
+    int32_t rows; ///< Высота кадра.
+    int32_t cols; ///< Ширина кадра.
+    int32_t type; ///< Тип кадра OpenCV.
+    uint32_t reserved; ///< Зарезервировано.
+    uint64_t step; ///< Длина строки кадра в байтах.
+    uint64_t slot_stride; ///< Расстояние между слотами в байтах.
+    uint64_t data_offset; ///< Смещение первого слота от начала памяти.
+    alignas(RING_ALIGNMENT) std::atomic<uint64_t> published; ///< Количество опубликованных кадров.
+    std::atomic<uint32_t> closed; ///< Производитель закрыл кольцо.
+    std::atomic<uint32_t> ready; ///< Заголовок заполнен, кольцо можно открывать.
+};
+
+/**
+ * @struct SharedFrameRing::SlotHeader
+ * @brief Заголовок слота, за ним (с выравниванием) следуют данные кадра.
+ */
+struct SharedFrameRing::SlotHeader {
+    std::atomic<uint64_t> version; ///< Версия слота: нечётная, пока производитель пишет кадр.
+    std::atomic<uint64_t> frame_number; ///< Номер кадра в слоте.
+    std::atomic<double> timestamp; ///< Время кадра, с.
+};
+
+/**
+ * @brief Округляет размер вверх до выравнивания слотов.
+ * @param size Размер в байтах.
+ * @return Выровненный размер.
+ */
+static size_t alignUp(size_t size) {
+    return (size + RING_ALIGNMENT - 1) / RING_ALIGNMENT * RING_ALIGNMENT;
+}
+
+/**
+ * @brief Приводит имя к виду, который требует shm_open (с ведущей косой чертой).
+ * @param name Имя кольца.
+ * @return Имя объекта разделяемой памяти.
+ */
+static std::string sharedMemoryName(const std::string& name) {
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+/**
+ * @brief Деструктор закрывает кольцо.
+ */
+SharedFrameRing::~SharedFrameRing() {
+    close();
+}
+
+/**
+ * @brief Создаёт кольцо.
+ * @param name Имя объекта разделяемой памяти.
+ * @param slot_count Количество слотов.
+ * @param size Размер кадра.
+ * @param type Тип кадра OpenCV.
+ * @return true, если кольцо создано.
+ */
+bool SharedFrameRing::create(const std::string& name, size_t slot_count, cv::Size size, int type) {
+    close();
+
+    // С одним слотом потребитель никогда не получит кадр: единственный слот всегда либо
+    // записывается, либо совпадает с последним опубликованным
+    if (slot_count < MIN_SLOT_COUNT || size.width <= 0 || size.height <= 0) {
+        std::cerr << "Invalid frame ring geometry" << std::endl;
+        return false;
+    }
+
+    size_t step = static_cast<size_t>(size.width) * CV_ELEM_SIZE(type);
+    size_t slot_stride = alignUp(sizeof(SlotHeader)) + alignUp(step * size.height);
+    size_t data_offset = alignUp(sizeof(RingHeader));
+    size_t total = data_offset + slot_stride * slot_count;
+
+    // Кольцо, оставшееся от упавшего производителя, заменяется новым
+    std::string shm_name = sharedMemoryName(name);
+    shm_unlink(shm_name.c_str());
+    int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Unable to create frame ring " << shm_name << std::endl;
+        return false;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        std::cerr << "Unable to allocate frame ring " << shm_name << std::endl;
+        ::close(fd);
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Unable to map frame ring " << shm_name << std::endl;
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+    this->name = shm_name;
+    mapping = mapped;
+    mapping_size = total;
+    owner = true;
+
+    // Память после ftruncate заполнена нулями, атомарные поля создаются на месте
+    header = new (mapping) RingHeader();
+    std::memcpy(header->magic, RING_MAGIC, sizeof(RING_MAGIC));
+    header->version = RING_VERSION;
+    header->slot_count = static_cast<uint32_t>(slot_count);
+    header->rows = size.height;
+    header->cols = size.width;
+    header->type = type;
+    header->step = step;
+    header->slot_stride = slot_stride;
+    header->data_offset = data_offset;
+    for (size_t i = 0; i < slot_count; i++) {
+        new (slotHeader(i)) SlotHeader();
+    }
+
+    // Потребители открывают кольцо только после заполнения заголовка
+    header->ready.store(1, std::memory_order_release);
+    cursor = 0;
+    return true;
+}
+
+/**
+ * @brief Открывает существующее кольцо для чтения.
+ * @param name Имя объекта разделяемой памяти.
+ * @return true, если кольцо открыто.
+ */
+bool SharedFrameRing::open(const std::string& name) {
+    close();
+
+    std::string shm_name = sharedMemoryName(name);
+    int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "Unable to open frame ring " << shm_name << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(RingHeader))) {
+        std::cerr << "Frame ring " << shm_name << " is not initialized" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Unable to map frame ring " << shm_name << std::endl;
+        return false;
+    }
+    this->name = shm_name;
+    mapping = mapped;
+    mapping_size = info.st_size;
+    header = static_cast<RingHeader*>(mapping);
+
+    bool valid = header->ready.load(std::memory_order_acquire) == 1 &&
+                 std::memcmp(header->magic, RING_MAGIC, sizeof(RING_MAGIC)) == 0 &&
+                 header->version == RING_VERSION && header->slot_count > 0 &&
+                 header->data_offset + header->slot_stride * header->slot_count <= mapping_size;
+    if (!valid) {
+        std::cerr << "Frame ring " << shm_name << " has unsupported format" << std::endl;
+        close();
+        return false;
+    }
+
+    // Потребитель получает только кадры, опубликованные после подключения
+    cursor = header->published.load(std::memory_order_acquire);
+    dropped_frames = 0;
+    return true;
+}
+
+/**
+ * @brief Закрывает кольцо.
+ */
+void SharedFrameRing::close() {
+    if (mapping) {
+        if (owner) {
+            header->closed.store(1, std::memory_order_release);
+        }
+        munmap(mapping, mapping_size);
+        if (owner) {
+            shm_unlink(name.c_str());
+        }
+    }
+    mapping = nullptr;
+    mapping_size = 0;
+    header = nullptr;
+    owner = false;
+    name.clear();
+}
+
+/**
+ * @brief Проверяет, открыто ли кольцо.
+ * @return true, если кольцо открыто.
+ */
+bool SharedFrameRing::isOpen() const {
+    return header != nullptr;
+}
+
+/**
+ * @brief Публикует кадр.
+ * @param frame Кадр с размером и типом кольца.
+ * @param timestamp Время кадра, с.
+ * @return true, если кадр опубликован.
+ */
+bool SharedFrameRing::write(const cv::Mat& frame, double timestamp) {
+    if (!owner || frame.size() != frameSize() || frame.type() != frameType()) {
+        return false;
+    }
+
+    uint64_t frame_number = header->published.load(std::memory_order_relaxed);
+    size_t slot = static_cast<size_t>(frame_number % header->slot_count);
+    SlotHeader* slot_header = slotHeader(slot);
+
+    // Нечётная версия: потребители, читающие этот слот, увидят, что он перезаписывается
+    uint64_t version = slot_header->version.load(std::memory_order_relaxed);
+    slot_header->version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot_header->frame_number.store(frame_number, std::memory_order_relaxed);
+    slot_header->timestamp.store(timestamp, std::memory_order_relaxed);
+    cv::Mat target(header->rows, header->cols, header->type, slotData(slot), header->step);
+    frame.copyTo(target);
+
+    slot_header->version.store(version + 2, std::memory_order_release);
+    header->published.store(frame_number + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Получает следующий непрочитанный кадр без копирования.
+ * @param view Кадр из слота.
+ * @param latest Пропустить все кадры, кроме самого свежего.
+ * @return true, если получен новый кадр.
+ */
+bool SharedFrameRing::acquire(View& view, bool latest) {
+    if (!header) {
+        return false;
+    }
+
+    const uint64_t slot_count = header->slot_count;
+    while (true) {
+        uint64_t published = header->published.load(std::memory_order_acquire);
+        if (cursor >= published) {
+            return false;
+        }
+
+        // Самый старый слот может уже перезаписываться следующим кадром, поэтому он тоже пропускается
+        uint64_t oldest = latest ? published - 1 : (published >= slot_count ? published - slot_count + 1 : 0);
+        if (cursor < oldest) {
+            dropped_frames += oldest - cursor;
+            cursor = oldest;
+        }
+
+        size_t slot = static_cast<size_t>(cursor % slot_count);
+        SlotHeader* slot_header = slotHeader(slot);
+        uint64_t version = slot_header->version.load(std::memory_order_acquire);
+        if ((version & 1) == 0 && slot_header->frame_number.load(std::memory_order_relaxed) == cursor) {
+            view.mat = cv::Mat(header->rows, header->cols, header->type, slotData(slot), header->step);
+            view.timestamp = slot_header->timestamp.load(std::memory_order_relaxed);
+            view.frame_number = cursor;
+            view.slot = slot;
+            view.version = version;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot_header->version.load(std::memory_order_relaxed) == version) {
+                cursor++;
+                return true;
+            }
+        }
+        // Производитель обогнал потребителя во время чтения; позиция пересчитывается по новой голове
+    }
+}
+
+/**
+ * @brief Проверяет, что слот не перезаписан с момента acquire.
+ * @param view Кадр, полученный через acquire.
+ * @return true, если данные кадра всё ещё целы.
+ */
+bool SharedFrameRing::isValid(const View& view) const {
+    if (!header || view.mat.empty() || view.slot >= header->slot_count) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slotHeader(view.slot)->version.load(std::memory_order_relaxed) == view.version;
+}
+
+/**
+ * @brief Копирует следующий непрочитанный кадр.
+ * @param frame Кадр, в который копируются данные.
+ * @param timestamp Время кадра, с.
+ * @param latest Пропустить все кадры, кроме самого свежего.
+ * @return true, если получен новый кадр.
+ */
+bool SharedFrameRing::read(cv::Mat& frame, double& timestamp, bool latest) {
+    View view;
+    while (acquire(view, latest)) {
+        view.mat.copyTo(frame);
+        if (isValid(view)) {
+            timestamp = view.timestamp;
+            return true;
+        }
+        // Слот перезаписан во время копирования, берётся следующий кадр
+    }
+    return false;
+}
+
+/**
+ * @brief Проверяет, закрыл ли производитель кольцо.
+ * @return true, если новых кадров больше не будет.
+ */
+bool SharedFrameRing::producerClosed() const {
+    return header && header->closed.load(std::memory_order_acquire) != 0;
+}
+
+/**
+ * @brief Получает количество пропущенных кадров.
+ * @return Количество пропущенных кадров.
+ */
+uint64_t SharedFrameRing::dropped() const {
+    return dropped_frames;
+}
+
+/**
+ * @brief Получает размер кадра.
+ * @return Размер кадра.
+ */
+cv::Size SharedFrameRing::frameSize() const {
+    return header ? cv::Size(header->cols, header->rows) : cv::Size();
+}
+
+/**
+ * @brief Получает тип кадра OpenCV.
+ * @return Тип кадра.
+ */
+int SharedFrameRing::frameType() const {
+    return header ? header->type : -1;
+}
+
+/**
+ * @brief Получает количество слотов.
+ * @return Количество слотов.
+ */
+size_t SharedFrameRing::slotCount() const {
+    return header ? header->slot_count : 0;
+}
+
+/**
+ * @brief Получает заголовок слота.
+ * @param slot Индекс слота.
+ * @return Заголовок слота в разделяемой памяти.
+ */
+SharedFrameRing::SlotHeader* SharedFrameRing::slotHeader(size_t slot) const {
+    char* base = static_cast<char*>(mapping) + header->data_offset + header->slot_stride * slot;
+    return reinterpret_cast<SlotHeader*>(base);
+}
+
+/**
+ * @brief Получает данные кадра в слоте.
+ * @param slot Индекс слота.
+ * @return Указатель на первый пиксель.
+ */
+uchar* SharedFrameRing::slotData(size_t slot) const {
+    return reinterpret_cast<uchar*>(slotHeader(slot)) + alignUp(sizeof(SlotHeader));
+}
@@ -0,0 +1,169 @@
+/**
+ * @file SharedFrameRing.h
+ * @brief Объявление класса SharedFrameRing.
+ */
+
+#ifndef SHAREDFRAMERING_H
+#define SHAREDFRAMERING_H
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class SharedFrameRing
+ * @brief Кольцевой буфер несжатых кадров в разделяемой памяти POSIX: один процесс-производитель,
+ * любое количество процессов-потребителей.
+ * Все кадры кольца имеют одинаковые размер и тип. Каждый слот защищён счётчиком версии (seqlock):
+ * нечётное значение означает, что производитель пишет в слот, поэтому ни производитель,
+ * ни потребители никогда не блокируются. Потребитель может читать кадр прямо из слота
+ * (cv::Mat поверх разделяемой памяти без копирования) и после обработки проверить через isValid,
+ * что производитель не перезаписал слот за это время.
+ *
+ * Каждый объект хранит собственную позицию чтения, поэтому потоки-потребители одного процесса
+ * открывают кольцо каждый своим объектом.
+ */
+class SharedFrameRing {
+
+public:
+    /**
+     * @brief Наименьшее количество слотов: производитель пишет в один слот, пока потребители читают другой.
+     */
+    static constexpr size_t MIN_SLOT_COUNT = 2;
+
+    /**
+     * @struct View
+     * @brief Кадр, прочитанный из слота без копирования.
+     */
+    struct View {
+        cv::Mat mat; ///< Заголовок поверх памяти слота; только для чтения.
+        double timestamp = 0.0; ///< Время кадра, заданное производителем, с.
+        uint64_t frame_number = 0; ///< Порядковый номер кадра с момента создания кольца.
+        size_t slot = 0; ///< Индекс слота.
+        uint64_t version = 0; ///< Версия слота на момент чтения.
+    };
+
+    /**
+     * @brief Конструктор пустого кольца.
+     */
+    SharedFrameRing() {};
+
+    /**
+     * @brief Деструктор закрывает кольцо; кольцо производителя удаляется.
+     */
+    ~SharedFrameRing();
+
+    SharedFrameRing(const SharedFrameRing&) = delete;
+    SharedFrameRing& operator=(const SharedFrameRing&) = delete;
+
+    /**
+     * @brief Создаёт кольцо (вызывается производителем). Существующее кольцо с тем же именем заменяется.
+     * @param name Имя объекта разделяемой памяти (например, "/emotion_frames").
+     * @param slot_count Количество слотов, не меньше MIN_SLOT_COUNT.
+     * @param size Размер кадра.
+     * @param type Тип кадра OpenCV.
+     * @return true, если кольцо создано.
+     */
+    bool create(const std::string& name, size_t slot_count, cv::Size size, int type);
+
+    /**
+     * @brief Открывает существующее кольцо для чтения (вызывается потребителем).
+     * Чтение начинается с кадров, опубликованных после открытия.
+     * @param name Имя объекта разделяемой памяти.
+     * @return true, если кольцо открыто.
+     */
+    bool open(const std::string& name);
+
+    /**
+     * @brief Закрывает кольцо. Производитель отмечает кольцо закрытым и удаляет имя;
+     * уже открытые потребители дочитывают опубликованные кадры.
+     */
+    void close();
+
+    /**
+     * @brief Проверяет, открыто ли кольцо.
+     * @return true, если кольцо открыто.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Публикует кадр, перезаписывая самый старый слот (только производитель).
+     * @param frame Кадр с размером и типом кольца.
+     * @param timestamp Время кадра, с.
+     * @return true, если кадр опубликован.
+     */
+    bool write(const cv::Mat& frame, double timestamp);
+
+    /**
+     * @brief Получает следующий непрочитанный кадр без копирования (только потребитель).
+     * Если потребитель отстал больше чем на размер кольца, пропущенные кадры учитываются в dropped.
+     * @param view Кадр из слота.
+     * @param latest Пропустить все кадры, кроме самого свежего.
+     * @return true, если получен новый кадр.
+     */
+    bool acquire(View& view, bool latest = false);
+
+    /**
+     * @brief Проверяет, что слот не перезаписан с момента acquire.
+     * @param view Кадр, полученный через acquire.
+     * @return true, если данные кадра всё ещё целы.
+     */
+    bool isValid(const View& view) const;
+
+    /**
+     * @brief Копирует следующий непрочитанный кадр, повторяя чтение при перезаписи слота.
+     * @param frame Кадр, в который копируются данные.
+     * @param timestamp Время кадра, с.
+     * @param latest Пропустить все кадры, кроме самого свежего.
+     * @return true, если получен новый кадр.
+     */
+    bool read(cv::Mat& frame, double& timestamp, bool latest = false);
+
+    /**
+     * @brief Проверяет, закрыл ли производитель кольцо.
+     * @return true, если новых кадров больше не будет.
+     */
+    bool producerClosed() const;
+
+    /**
+     * @brief Получает количество кадров, пропущенных этим потребителем из-за отставания.
+     * @return Количество пропущенных кадров.
+     */
+    uint64_t dropped() const;
+
+    /**
+     * @brief Получает размер кадра.
+     * @return Размер кадра.
+     */
+    cv::Size frameSize() const;
+
+    /**
+     * @brief Получает тип кадра OpenCV.
+     * @return Тип кадра.
+     */
+    int frameType() const;
+
+    /**
+     * @brief Получает количество слотов.
+     * @return Количество слотов.
+     */
+    size_t slotCount() const;
+
+private:
+    struct RingHeader;
+    struct SlotHeader;
+
+    SlotHeader* slotHeader(size_t slot) const;
+    uchar* slotData(size_t slot) const;
+
+    std::string name; ///< Имя объекта разделяемой памяти.
+    void* mapping = nullptr; ///< Отображённая память.
+    size_t mapping_size = 0; ///< Размер отображённой памяти.
+    RingHeader* header = nullptr; ///< Заголовок кольца в отображённой памяти.
+    bool owner = false; ///< Кольцо создано этим объектом.
+    uint64_t cursor = 0; ///< Номер следующего кадра для чтения.
+    uint64_t dropped_frames = 0; ///< Количество пропущенных кадров.
+};
+
+#endif
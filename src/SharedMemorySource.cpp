@@ -0,0 +1,88 @@
+/**
+ * @file SharedMemorySource.cpp
+ * @brief Реализация методов класса SharedMemorySource.
+ */
+
+#include <opencv2/videoio.hpp>
+#include <thread>
+#include "SharedMemorySource.h"
+
+/**
+ * @brief Интервал опроса кольца в ожидании нового кадра.
+ */
+static const std::chrono::microseconds POLL_INTERVAL(500);
+
+/**
+ * @brief Конструктор подключается к кольцу.
+ * @param name Имя кольца.
+ * @param timeout Наибольшее время ожидания нового кадра.
+ */
+SharedMemorySource::SharedMemorySource(const std::string& name, std::chrono::milliseconds timeout)
+    : timeout(timeout) {
+    ring.open(name);
+}
+
+/**
+ * @brief Проверяет, открыт ли источник.
+ * @return true, если кольцо открыто.
+ */
+bool SharedMemorySource::isOpened() const {
+    return ring.isOpen();
+}
+
+/**
+ * @brief Считывает самый свежий кадр без копирования.
+ * @param frame Заголовок поверх слота кольца.
+ * @return false, если производитель закрыл кольцо или не публикует кадры дольше таймаута.
+ */
+bool SharedMemorySource::read(cv::Mat& frame) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!ring.acquire(view, true)) {
+        if (!ring.isOpen() || ring.producerClosed() || std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+
+    frame = view.mat;
+    return true;
+}
+
+/**
+ * @brief Получает время последнего считанного кадра.
+ * @return Время, заданное производителем, с.
+ */
+double SharedMemorySource::timestamp() const {
+    return view.timestamp;
+}
+
+/**
+ * @brief Получает свойство источника: поддерживаются размер кадра.
+ * @param property Идентификатор свойства.
+ * @return Значение свойства или 0.
+ */
+double SharedMemorySource::get(int property) const {
+    if (property == cv::CAP_PROP_FRAME_WIDTH) {
+        return ring.frameSize().width;
+    }
+    if (property == cv::CAP_PROP_FRAME_HEIGHT) {
+        return ring.frameSize().height;
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Проверяет, что последний считанный кадр не перезаписан производителем.
+ * @return true, если данные последнего кадра всё ещё целы.
+ */
+bool SharedMemorySource::lastFrameValid() const {
+    return ring.isValid(view);
+}
+
+/**
+ * @brief Получает количество пропущенных кадров.
+ * @return Количество пропущенных кадров.
+ */
+uint64_t SharedMemorySource::dropped() const {
+    return ring.dropped();
+}
@@ -0,0 +1,58 @@
+/**
+ * @file SharedMemorySource.h
+ * @brief Объявление класса SharedMemorySource.
+ */
+
+#ifndef SHAREDMEMORYSOURCE_H
+#define SHAREDMEMORYSOURCE_H
+
+#include <chrono>
+#include <string>
+#include "FrameSource.h"
+#include "SharedFrameRing.h"
+
+/**
+ * @class SharedMemorySource
+ * @brief Источник кадров из кольца в разделяемой памяти, которое заполняет другой процесс.
+ * Кадр возвращается без копирования: cv::Mat указывает прямо на слот кольца. Читается всегда
+ * самый свежий кадр, как у камеры, поэтому медленная обработка не накапливает задержку.
+ * Производитель может перезаписать слот в любой момент, поэтому результаты обработки и копии
+ * кадра принимаются только после проверки lastFrameValid.
+ */
+class SharedMemorySource : public FrameSource {
+
+public:
+    /**
+     * @brief Конструктор подключается к кольцу.
+     * @param name Имя кольца.
+     * @param timeout Наибольшее время ожидания нового кадра, после которого производитель считается отключённым.
+     */
+    explicit SharedMemorySource(const std::string& name,
+                                std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
+
+    bool isOpened() const override;
+    bool read(cv::Mat& frame) override;
+    double timestamp() const override;
+    double get(int property) const override;
+
+    /**
+     * @brief Проверяет, что последний считанный кадр не перезаписан производителем.
+     * Вызывается после обработки кадра и после его копирования: если проверка не прошла,
+     * результаты обработки и копия могут относиться к другому или разорванному кадру.
+     * @return true, если данные последнего кадра всё ещё целы.
+     */
+    bool lastFrameValid() const override;
+
+    /**
+     * @brief Получает количество кадров, пропущенных из-за медленной обработки.
+     * @return Количество пропущенных кадров.
+     */
+    uint64_t dropped() const;
+
+private:
+    SharedFrameRing ring; ///< Кольцо кадров.
+    SharedFrameRing::View view; ///< Последний считанный кадр.
+    std::chrono::milliseconds timeout; ///< Время ожидания нового кадра.
+};
+
+#endif
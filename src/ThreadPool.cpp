@@ -0,0 +1,63 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Реализация методов класса ThreadPool.
+ */
+
+#include <algorithm>
+#include "ThreadPool.h"
+
+/**
+ * @brief Конструктор запускает рабочие потоки.
+ * @param threads Количество потоков; 0 означает количество ядер процессора.
+ */
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Деструктор дожидается выполнения всех поставленных задач и останавливает потоки.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    task_added.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Получает количество рабочих потоков.
+ * @return Количество потоков.
+ */
+size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+/**
+ * @brief Цикл рабочего потока: выполняет задачи из очереди до остановки пула.
+ */
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task_added.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file ThreadPool.h
+ * @brief Объявление класса ThreadPool.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Пул потоков фиксированного размера с общей очередью задач.
+ */
+class ThreadPool {
+
+public:
+    /**
+     * @brief Конструктор запускает рабочие потоки.
+     * @param threads Количество потоков; 0 означает количество ядер процессора.
+     */
+    explicit ThreadPool(size_t threads = 0);
+
+    /**
+     * @brief Деструктор дожидается выполнения всех поставленных задач и останавливает потоки.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Ставит задачу в очередь.
+     * @param task Задача без аргументов.
+     * @return Future с результатом задачи; исключение задачи передаётся через future.
+     */
+    template <typename F>
+    auto submit(F task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push([packaged]() { (*packaged)(); });
+        }
+        task_added.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief Получает количество рабочих потоков.
+     * @return Количество потоков.
+     */
+    size_t size() const;
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers; ///< Рабочие потоки.
+    std::queue<std::function<void()>> tasks; ///< Очередь задач.
+    std::mutex mutex; ///< Защита очереди задач.
+    std::condition_variable task_added; ///< Сигнал о новой задаче или остановке.
+    bool stopping = false; ///< Признак остановки пула.
+};
+
+#endif
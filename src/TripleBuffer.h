@@ -0,0 +1,65 @@
+/**
+ * @file TripleBuffer.h
+ * @brief Объявление шаблона TripleBuffer.
+ */
+
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @class TripleBuffer
+ * @brief Тройной буфер без блокировок для передачи последнего значения от одного потока-производителя одному потоку-потребителю.
+ * Производитель никогда не ждёт потребителя: если потребитель не успевает, промежуточные значения перезаписываются.
+ */
+template <typename T>
+class TripleBuffer {
+
+public:
+    /**
+     * @brief Записывает новое значение (вызывается только потоком-производителем).
+     * @param value Значение, которое нужно опубликовать.
+     */
+    void write(T value) {
+        buffers[back] = std::move(value);
+
+        // Обмен заднего буфера со средним и установка признака нового значения
+        uint8_t previous = state.exchange(static_cast<uint8_t>(back | DIRTY), std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+
+        // Устаревшее значение больше не будет прочитано, освобождаем его сразу
+        buffers[back] = T();
+    }
+
+    /**
+     * @brief Забирает самое свежее значение (вызывается только потоком-потребителем).
+     * @param value Переменная, в которую будет перемещено значение.
+     * @return true, если с момента прошлого чтения было опубликовано новое значение.
+     */
+    bool read(T& value) {
+        if (!(state.load(std::memory_order_acquire) & DIRTY)) {
+            return false;
+        }
+
+        // Обмен переднего буфера со средним и сброс признака нового значения
+        uint8_t previous = state.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX_MASK;
+
+        value = std::move(buffers[front]);
+        return true;
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3; ///< Маска индекса среднего буфера.
+    static constexpr uint8_t DIRTY = 0x4; ///< Признак неполученного значения в среднем буфере.
+
+    T buffers[3]; ///< Задний, средний и передний буферы.
+    std::atomic<uint8_t> state{1}; ///< Индекс среднего буфера и признак нового значения.
+    uint8_t back = 0; ///< Индекс буфера производителя.
+    uint8_t front = 2; ///< Индекс буфера потребителя.
+};
+
+#endif
@@ -1,5 +1,5 @@
 #include "Video.h"
-#include <opencv2/opencv.hpp>
+#include <opencv2/imgcodecs.hpp>
 
 Video::Video(cv::VideoCapture& capture) : capture(capture) {
     // Получаем количество кадров в секунду
@@ -16,16 +16,21 @@ double Video::getLengthInSeconds() const {
 }
 
 cv::Mat Video::operator[](double seconds) const {
+    // Читаем и возвращаем кадр в новый буфер
+    cv::Mat frame;
+    read(seconds, frame);
+    return frame;
+}
+
+bool Video::read(double seconds, cv::Mat& frame) const {
     // Вычисляем номер кадра на основе заданного времени в секундах
     int frameNumber = static_cast<int>(seconds * fps);
 
     // Устанавливаем положение кадра
     capture.set(cv::CAP_PROP_POS_FRAMES, frameNumber);
 
-    // Читаем и возвращаем кадр
-    cv::Mat frame;
-    capture.read(frame);
-    return frame;
+    // Читаем кадр; буфер переиспользуется, если размер кадра не изменился
+    return capture.read(frame);
 }
 cv::Mat Video::getFrame(int frameNumber) const {
     // Устанавливаем положение кадра
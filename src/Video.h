@@ -1,7 +1,8 @@
 #ifndef VIDEO_H
 #define VIDEO_H
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
 
 class Video {
 public:
@@ -14,6 +15,9 @@ public:
     // Оператор для доступа к кадру в заданную секунду
     cv::Mat operator[](double seconds) const;
 
+    // Чтение кадра в заданную секунду в существующий буфер (например, из FramePool) без выделения памяти
+    bool read(double seconds, cv::Mat& frame) const;
+
     cv::Mat getFrame(int frameNumber) const;
 
     bool saveFrame(int frameNumber, const std::string& filename) const;
@@ -12,27 +12,39 @@
 #include <thread>
 #include <algorithm>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <unordered_map>
 #include <string>
 #include <iomanip>
+#include <memory>
 
+#include "CaptureSource.h"
+#include "FaceBudget.h"
 #include "FaceDetector.h"
+#include "FaceQuality.h"
+#include "FrameClassifier.h"
+#include "FrameDisplay.h"
+#include "FrameRecorder.h"
+#include "FramePool.h"
+#include "FrameRenderer.h"
 #include "Image.h"
+#include "LatencyStats.h"
 #include "Model.h"
+#include "ModelBundle.h"
+#include "MotionSampler.h"
+#include "QualityController.h"
+#include "ReplaySource.h"
+#include "ResultStore.h"
+#include "SharedMemorySource.h"
 #include "Video.h"
 
-#ifndef TEST_ENV
-
-
 /**
- * @brief Путь к модели для детекции лиц с использованием каскадных классификаторов.
+ * @brief Количество кадров в пуле захвата камеры: кадр в обработке, кадр в тройном буфере,
+ * кадр на экране и один запасной.
  */
-const std::string FACE_DETECTOR_MODEL_PATH = "../model/haarcascade_frontalface_alt2.xml";
-/**
- * @brief Путь к модели TensorFlow для предсказания эмоций.
- */
-const std::string TENSORFLOW_MODEL_PATH = "../model/tensorflow_model.pb";
+const size_t CAMERA_FRAME_POOL_SIZE = 4;
 /**
  * @brief Название приложения.
  */
@@ -131,12 +143,459 @@ void plotEmotionGraph(const std::vector<std::string>& emotions) {
     cv::waitKey(0);
 }
 
+/**
+ * @struct CliOptions
+ * @brief Параметры командной строки.
+ */
+struct CliOptions {
+    bool headless = false; ///< Не создавать окно и не отображать кадры.
+    bool pace = false; ///< Ограничивать скорость обработки частотой кадров камеры.
+    bool adaptive = false; ///< Обрабатывать с камеры только кадры с заметным изменением сцены.
+    bool every_second = false; ///< Обрабатывать каждую секунду видео без адаптивной выборки.
+    bool luma = false; ///< Захватывать с камеры только плоскость яркости.
+    bool tiled = false; ///< Тайловая детекция лиц на больших кадрах во всех потоках процессора.
+    std::string bundle_path = ModelBundle::DEFAULT_PATH; ///< Путь к пакету моделей.
+    bool bundle_required = false; ///< Пакет моделей задан явно (--bundle): без него запуск прерывается.
+    bool bundle_verify = false; ///< Проверять контрольные суммы содержимого пакета (--verify-bundle).
+    std::string shm_name; ///< Кольцо кадров в разделяемой памяти вместо камеры.
+    bool quality_gate = true; ///< Не передавать в модель размытые, обрезанные и малоконтрастные лица.
+    double slo_ms = 0; ///< Целевая задержка обработки кадра камеры, мс (0 - без регулятора качества).
+    std::string record_path; ///< Файл, в который записываются кадры режима камеры.
+    bool record_png = false; ///< Сжимать записываемые кадры в PNG без потерь.
+    std::string replay_path; ///< Запись кадров, воспроизводимая вместо камеры.
+    bool replay_max_speed = false; ///< Воспроизводить запись без ожидания записанного времени кадров.
+    bool replay_preload = false; ///< Декодировать запись в память до начала обработки.
+    std::string results_path; ///< Хранилище результатов режима видео (пусто - не сохранять).
+    size_t max_faces = 0; ///< Наибольшее число предсказаний на кадр камеры (0 - без ограничения).
+    double face_budget_ms = 0; ///< Наибольшее время предсказаний на кадр камеры, мс (0 - без ограничения).
+    FaceBudget::Priority face_priority = FaceBudget::LARGEST; ///< Порядок, в котором лица получают предсказания.
+};
+
+/**
+ * @brief Загружает модель эмоций из пакета моделей, если он открыт, иначе из файла.
+ * @param bundle Пакет моделей.
+ * @return Модель.
+ */
+Model loadModel(const ModelBundle& bundle) {
+    return bundle.isOpen() ? Model(bundle) : Model(ModelBundle::DEFAULT_MODEL_PATH);
+}
+
+/**
+ * @brief Загружает детектор лиц из пакета моделей, если он открыт, иначе из файла.
+ * @param bundle Пакет моделей.
+ * @return Детектор лиц.
+ */
+FaceDetector loadFaceDetector(const ModelBundle& bundle) {
+    return bundle.isOpen() ? FaceDetector(bundle) : FaceDetector(ModelBundle::DEFAULT_CASCADE_PATH);
+}
+
+/**
+ * @brief Настраивает детектор лиц с учётом параметров командной строки.
+ * @param face_detector Детектор лиц.
+ * @param options Параметры командной строки.
+ */
+void configureFaceDetector(FaceDetector& face_detector, const CliOptions& options) {
+    if (options.tiled) {
+        // hardware_concurrency() может вернуть 0, а setTiling(0) отключает тайлы
+        face_detector.setTiling(std::max(1u, std::thread::hardware_concurrency()));
+    }
+}
+
+/**
+ * @brief Переводит детектор лиц и бюджет предсказаний на уровень качества регулятора.
+ * Ограничение числа лиц уровня сокращает только предсказания: все найденные лица
+ * остаются в кадре с перенесёнными подписями.
+ * @param face_detector Детектор лиц.
+ * @param budget Бюджет предсказаний на кадр.
+ * @param level Уровень качества.
+ */
+void applyQualityLevel(FaceDetector& face_detector, FaceBudget& budget, const QualityController::Level& level) {
+    face_detector.setScale(level.scale_factor, level.min_face_size);
+    budget.setFrameLimit(level.max_faces);
+}
+
+/**
+ * @brief Выводит лица, отклонённые оценкой качества.
+ * @param scores Оценки всех найденных лиц.
+ */
+void printSkippedFaces(const std::vector<FaceQuality::Score>& scores) {
+    for (size_t i = 0; i < scores.size(); i++) {
+        if (!scores[i].accepted()) {
+            std::cout << "face " << i << " skipped: " << FaceQuality::reasonName(scores[i].reason)
+                      << " (contrast " << scores[i].contrast << ", sharpness " << scores[i].sharpness << ")" << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Открывает источник кадров для режима камеры.
+ * @param options Параметры командной строки.
+ * @return Запись или кольцо кадров в разделяемой памяти, если заданы, иначе камера по умолчанию.
+ */
+std::unique_ptr<FrameSource> openFrameSource(const CliOptions& options) {
+    if (!options.replay_path.empty()) {
+        return std::unique_ptr<FrameSource>(new ReplaySource(options.replay_path,
+            options.replay_max_speed ? ReplaySource::MAX_SPEED : ReplaySource::RECORDED_SPEED, options.replay_preload));
+    }
+    if (!options.shm_name.empty()) {
+        return std::unique_ptr<FrameSource>(new SharedMemorySource(options.shm_name));
+    }
+    return std::unique_ptr<FrameSource>(new CaptureSource(0));
+}
+
+/**
+ * @brief Обработка видеопотока с камеры.
+ * Обработка выполняется в отдельном потоке без ожидания отрисовки, а главный поток
+ * только отображает последний обработанный кадр.
+ * @param options Параметры командной строки.
+ * @param bundle Пакет моделей.
+ * @return Код завершения программы.
+ */
+int runCamera(const CliOptions& options, const ModelBundle& bundle) {
+    bool headless = options.headless;
+    bool luma = options.luma;
+
+    // Инициализация всех необходимых объектов
+    Model model = loadModel(bundle);
+    FaceDetector face_detector = loadFaceDetector(bundle);
+    configureFaceDetector(face_detector, options);
+    FaceQuality quality;
+    std::vector<size_t> skipped_faces(FaceQuality::REASON_COUNT, 0);
+    // Пул создаётся до окна отображения, чтобы пережить все опубликованные кадры
+    FramePool frame_pool(CAMERA_FRAME_POOL_SIZE);
+    FrameDisplay display(APP_NAME);
+    std::atomic<bool> stop{false};
+
+    // Инициализация источника кадров: камера по умолчанию или кольцо в разделяемой памяти
+    std::unique_ptr<FrameSource> source = openFrameSource(options);
+    bool zero_copy = !options.shm_name.empty() && options.replay_path.empty();
+    uint64_t overwritten_frames = 0;
+
+    if (luma) {
+        // Без конвертации в BGR камера отдаёт YUV, из которого детектор берёт только яркость.
+        // Цветное изображение не нужно, поэтому окно не создаётся
+        source->set(cv::CAP_PROP_CONVERT_RGB, 0);
+        headless = true;
+    }
+
+    // Запись кадров источника для воспроизведения через --replay
+    std::unique_ptr<FrameRecorder> recorder;
+    if (!options.record_path.empty()) {
+        recorder.reset(new FrameRecorder(options.record_path, options.record_png ? RECORDING_PNG : RECORDING_RAW));
+    }
+
+    // Бюджет предсказаний на кадр: лица вне бюджета сохраняют прошлое предсказание своего трека
+    FaceBudget::Settings budget_settings;
+    budget_settings.priority = options.face_priority;
+    budget_settings.max_faces = options.max_faces;
+    budget_settings.max_ms = options.face_budget_ms;
+    FaceBudget budget(budget_settings);
+
+    // Период кадра камеры для ограничения скорости обработки
+    double fps = source->get(cv::CAP_PROP_FPS);
+    auto frame_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(fps > 0 ? 1.0 / fps : 0.0));
+
+    // Регулятор качества по целевой задержке кадра; без него каждый кадр обрабатывается полностью
+    std::unique_ptr<QualityController> controller;
+    LatencyStats frame_latency;
+    if (options.slo_ms > 0) {
+        QualityController::Settings controller_settings;
+        controller_settings.target_ms = options.slo_ms;
+        controller.reset(new QualityController(controller_settings));
+        applyQualityLevel(face_detector, budget, controller->level());
+    }
+
+    std::thread processing([&]() {
+        auto next_frame_time = std::chrono::steady_clock::now();
+
+        // Результаты последнего обработанного кадра переносятся на пропущенные кадры
+        MotionSampler sampler;
+        std::vector<cv::Rect> last_faces;
+        std::vector<std::string> last_prediction;
+        // Заголовок поверх слота кольца в разделяемой памяти
+        cv::Mat slot_frame;
+        // Треки и подписи бюджета до кадра из кольца, восстанавливаются вместе с результатами
+        FaceBudget previous_budget = budget;
+
+        // Время обработки кадра учитывается регулятором и для отброшенных кадров:
+        // иначе медленные кадры, которые производитель успел перезаписать, не снижали бы качество
+        auto recordFrameLatency = [&](std::chrono::steady_clock::time_point frame_started) {
+            if (!controller) {
+                return;
+            }
+            double frame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame_started).count();
+            frame_latency.record(frame_ms);
+            // Текущая рабочая точка выводится при каждом переключении уровня
+            if (controller->record(frame_ms)) {
+                applyQualityLevel(face_detector, budget, controller->level());
+                std::cout << "Quality " << controller->summary() << std::endl;
+            }
+        };
+
+        // Главный цикл обработки
+        while (!stop.load()) {
+            // Кадр из пула; если все кадры ещё заняты отображением, ждём освобождения
+            FramePool::Frame pooled_frame = frame_pool.acquire();
+            cv::Mat& frame = pooled_frame.mat();
+
+            // Считывание нового кадра с видео. Кольцо в разделяемой памяти отдаёт кадр без копирования:
+            // детектор работает прямо со слотом, а в буфер пула кадр копируется только для записи
+            // и отображения
+            cv::Mat& input = zero_copy ? slot_frame : frame;
+            bool bSuccess = source->read(input);
+            // Прерывание цикла, если не удается захватить кадры
+            if (!bSuccess) {
+                std::cout << (options.replay_path.empty() ? "Video camera is disconnected" : "End of recording")
+                          << ". Stopping the program" << std::endl;
+                break;
+            }
+
+            // Сжатый поток (например, MJPEG) без конвертации приходит одной строкой байтов
+            if (luma && input.rows == 1) {
+                std::cout << "Camera does not provide raw YUV frames, falling back to BGR capture" << std::endl;
+                source->set(cv::CAP_PROP_CONVERT_RGB, 1);
+                luma = false;
+                continue;
+            }
+
+            double timestamp = source->timestamp();
+
+            // Время обработки кадра без ожидания камеры и ограничения скорости
+            auto frame_started = std::chrono::steady_clock::now();
+            QualityController::Plan plan;
+            if (controller) {
+                plan = controller->plan();
+            }
+
+            // Результаты прошлого кадра восстанавливаются, если производитель перезапишет слот во время обработки
+            std::vector<cv::Rect> previous_faces = last_faces;
+            std::vector<std::string> previous_prediction = last_prediction;
+            if (zero_copy) {
+                previous_budget = budget;
+            }
+            if (plan.detect && (!options.adaptive || sampler.shouldProcess(input, timestamp))) {
+                // Выполнение детекции лиц
+                last_faces = face_detector.detectFace(input);
+
+                // Под нагрузкой предсказание выполняется не на каждой детекции: подписи переносятся
+                // с прошлого кадра, пока количество лиц не изменилось. Если слот перезаписан уже
+                // во время детекции, предсказание не выполняется: кадр всё равно будет отброшен
+                if (source->lastFrameValid() && (plan.infer || last_faces.size() != last_prediction.size())) {
+                    // Выделение областей интереса (ROI) из исходного кадра; непригодные лица пропускают модель
+                    std::vector<FaceQuality::Score> scores;
+                    Image image_and_ROI = FrameClassifier::extractFaces(face_detector, input, options.quality_gate, quality, scores);
+                    for (const FaceQuality::Score& score : scores) {
+                        skipped_faces[score.reason]++;
+                    }
+
+                    // Лица получают предсказания в порядке приоритета, пока не исчерпан бюджет кадра
+                    const std::vector<size_t>& order = budget.rank(last_faces, input.size());
+                    if (image_and_ROI.getROI().size() > 0) {
+                        // Предобработка изображения для модели
+                        image_and_ROI.preprocessROI();
+                        std::vector<cv::Mat> inputs = image_and_ROI.getModelInput();
+
+                        // Входы модели идут в порядке принятых лиц
+                        std::vector<size_t> input_index(scores.size(), inputs.size());
+                        for (size_t i = 0, next_input = 0; i < scores.size(); i++) {
+                            if (scores[i].accepted()) {
+                                input_index[i] = next_input++;
+                            }
+                        }
+
+                        // Выполнение предсказания. Рамки и текст предсказания рисует поток отображения
+                        auto inference_started = std::chrono::steady_clock::now();
+                        size_t inferred = 0;
+                        for (size_t face : order) {
+                            if (input_index[face] >= inputs.size()) {
+                                continue;
+                            }
+                            double inference_ms = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - inference_started).count();
+                            if (!budget.allows(inferred, inference_ms)) {
+                                break;
+                            }
+                            budget.setLabel(face, Model::formatPrediction(model.classifyFace(inputs[input_index[face]])));
+                            inferred++;
+                        }
+                    }
+
+                    // Подпись для каждой рамки: новое, перенесённое или ожидаемое предсказание либо причина пропуска
+                    std::vector<std::string> labels = budget.labels();
+                    std::vector<std::string> accepted_labels;
+                    for (size_t i = 0; i < scores.size() && i < labels.size(); i++) {
+                        if (scores[i].accepted()) {
+                            accepted_labels.push_back(labels[i]);
+                        }
+                    }
+                    last_prediction = FaceQuality::labelFaces(scores, accepted_labels);
+                }
+            }
+
+            // Слот копируется в буфер пула, и только после этого проверяется, что за время детекции,
+            // предсказания и копирования производитель его не перезаписал. Иначе кадр отбрасывается:
+            // рамки и подписи относились бы к другому кадру, а копия могла бы оказаться разорванной
+            if (zero_copy && (recorder || !headless)) {
+                input.copyTo(frame);
+            }
+            if (!source->lastFrameValid()) {
+                last_faces.swap(previous_faces);
+                last_prediction.swap(previous_prediction);
+                budget = previous_budget;
+                overwritten_frames++;
+                recordFrameLatency(frame_started);
+                continue;
+            }
+
+            if (recorder) {
+                recorder->write(frame, timestamp);
+            }
+
+            DisplayPacket packet;
+            packet.frame = pooled_frame;
+            packet.faces = last_faces;
+            packet.emotion_prediction = last_prediction;
+
+            if (!headless) {
+                display.publish(std::move(packet));
+            }
+
+            recordFrameLatency(frame_started);
+
+            if (options.pace && fps > 0) {
+                next_frame_time += frame_period;
+                std::this_thread::sleep_until(next_frame_time);
+            }
+        }
+
+        stop = true;
+    });
+
+    if (!headless) {
+        display.run(stop);
+    }
+
+    processing.join();
+
+    if (recorder) {
+        // Количество кадров читается после close: до этого часть кадров ещё в очереди записи
+        bool complete = recorder->close();
+        std::cout << "Recorded " << recorder->frameCount() << " frames to " << options.record_path
+                  << (complete ? "" : " (recording is incomplete)") << std::endl;
+    }
+
+    // Сводка по задержке кадров и времени работы на каждом уровне качества
+    if (controller) {
+        std::cout << "Frame latency: " << frame_latency.summary() << std::endl
+                  << "Final quality " << controller->summary() << std::endl;
+        for (size_t level = 0; level < controller->levelCount(); level++) {
+            if (controller->framesAtLevel(level) > 0) {
+                std::cout << "Frames at quality level " << level << ": " << controller->framesAtLevel(level) << std::endl;
+            }
+        }
+    }
+
+    if (overwritten_frames > 0) {
+        std::cout << "Frames overwritten by the producer during processing: " << overwritten_frames << std::endl;
+    }
+
+    // Сводка по бюджету предсказаний
+    if (options.max_faces > 0 || options.face_budget_ms > 0 || controller) {
+        std::cout << "Faces inferred: " << budget.inferredFaces() << ", carried forward: " << budget.carriedFaces()
+                  << ", pending: " << budget.pendingFaces() << std::endl;
+    }
+
+    // Сводка по лицам, не переданным в модель
+    for (int reason = FaceQuality::TOO_SMALL; reason < FaceQuality::REASON_COUNT; reason++) {
+        if (skipped_faces[reason] > 0) {
+            std::cout << "Faces skipped as " << FaceQuality::reasonName(static_cast<FaceQuality::Reason>(reason))
+                      << ": " << skipped_faces[reason] << std::endl;
+        }
+    }
+
+    return 0;
+}
+
 /**
  * @brief Главная функция программы.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы командной строки: --headless отключает отображение,
+ * --pace ограничивает скорость обработки частотой кадров камеры,
+ * --adaptive включает выборку кадров по изменению сцены для камеры,
+ * --every-second отключает её для видео (обработка каждой секунды, как раньше),
+ * --luma захватывает с камеры только плоскость яркости (без окна),
+ * --tiled включает тайловую детекцию лиц на больших кадрах,
+ * --bundle PATH задаёт пакет моделей (--verify-bundle - с проверкой контрольных сумм содержимого),
+ * --shm NAME читает кадры режима камеры из кольца в разделяемой памяти,
+ * --no-quality-gate передаёт в модель все найденные лица без оценки качества,
+ * --slo-ms MS включает регулятор качества режима камеры с целевой задержкой кадра MS,
+ * --record PATH записывает кадры режима камеры в файл (--record-png - со сжатием PNG без потерь),
+ * --replay PATH воспроизводит запись вместо камеры (--replay-max-speed - без ожидания времени кадров,
+ * --replay-preload - с декодированием всей записи до начала обработки),
+ * --results PATH сохраняет предсказания по каждому лицу режима видео в хранилище результатов,
+ * --max-faces N и --face-budget-ms MS ограничивают число и время предсказаний на кадр камеры,
+ * --face-priority largest|central|oldest задаёт порядок, в котором лица получают предсказания.
  * @return Код завершения программы.
  */
-int main()
+int main(int argc, char** argv)
 {
+    CliOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--pace") {
+            options.pace = true;
+        } else if (arg == "--adaptive") {
+            options.adaptive = true;
+        } else if (arg == "--every-second") {
+            options.every_second = true;
+        } else if (arg == "--luma") {
+            options.luma = true;
+        } else if (arg == "--tiled") {
+            options.tiled = true;
+        } else if (arg == "--bundle" && i + 1 < argc) {
+            options.bundle_path = argv[++i];
+            options.bundle_required = true;
+        } else if (arg == "--verify-bundle") {
+            options.bundle_verify = true;
+        } else if (arg == "--shm" && i + 1 < argc) {
+            options.shm_name = argv[++i];
+        } else if (arg == "--no-quality-gate") {
+            options.quality_gate = false;
+        } else if (arg == "--slo-ms" && i + 1 < argc) {
+            options.slo_ms = std::stod(argv[++i]);
+        } else if (arg == "--record" && i + 1 < argc) {
+            options.record_path = argv[++i];
+        } else if (arg == "--record-png") {
+            options.record_png = true;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            options.replay_path = argv[++i];
+        } else if (arg == "--replay-max-speed") {
+            options.replay_max_speed = true;
+        } else if (arg == "--replay-preload") {
+            options.replay_preload = true;
+        } else if (arg == "--results" && i + 1 < argc) {
+            options.results_path = argv[++i];
+        } else if (arg == "--max-faces" && i + 1 < argc) {
+            options.max_faces = std::stoul(argv[++i]);
+        } else if (arg == "--face-budget-ms" && i + 1 < argc) {
+            options.face_budget_ms = std::stod(argv[++i]);
+        } else if (arg == "--face-priority" && i + 1 < argc) {
+            if (!FaceBudget::parsePriority(argv[++i], options.face_priority)) {
+                std::cerr << "Unknown face priority " << argv[i] << ", expected largest, central or oldest" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Пакет моделей отображается в память; без пакета модели читаются из отдельных файлов
+    ModelBundle bundle;
+    if (!bundle.openForCli(options.bundle_path, options.bundle_required, options.bundle_verify)) {
+        return 1;
+    }
+
     // Инициализация видеокадра, который будет считываться с камеры
     // Инициализация всех необходимых объектов
     int anser{0};
@@ -147,8 +606,9 @@ int main()
     std::cin >> anser;
 
     if (!anser) {
-        Model model(TENSORFLOW_MODEL_PATH);
-        FaceDetector face_detector;
+        Model model = loadModel(bundle);
+        FaceDetector face_detector = loadFaceDetector(bundle);
+        configureFaceDetector(face_detector, options);
         Image image_and_ROI;
         std::cout << "input name of the image like <name.jpg>" << std::endl;
         cv::Mat frame;
@@ -159,38 +619,33 @@ int main()
         // Создание окна с названием приложения
         cv::namedWindow(APP_NAME);
 
-        // Главный цикл программы
-        // Выполнение детекции лиц и рисование рамок
-        face_detector.detectFace(frame);
+        // Выполнение детекции лиц
+        std::vector<cv::Rect> faces = face_detector.detectFace(frame);
 
-        // Рисование рамок на изображении
-        image_and_ROI = face_detector.drawBoundingBoxOnFrame(frame);
+        // Выделение областей интереса (ROI) из исходного кадра
+        FaceQuality quality;
+        std::vector<FaceQuality::Score> scores;
+        image_and_ROI = FrameClassifier::extractFaces(face_detector, frame, options.quality_gate, quality, scores);
+        printSkippedFaces(scores);
 
         // Получение областей интереса (ROI)
         std::vector<cv::Mat> roi_image = image_and_ROI.getROI();
+        std::vector<std::string> emotion_prediction;
 
         if (roi_image.size() > 0) {
             // Предобработка изображения для модели
             image_and_ROI.preprocessROI();
             // Выполнение предсказания
-            std::vector<std::string> emotion_prediction = model.predict(image_and_ROI);
+            emotion_prediction = model.predict(image_and_ROI);
             std::string emotion_prediction_2 = model.ans(image_and_ROI);
 
-            // Добавление текста предсказания на изображение
-            image_and_ROI = face_detector.printPredictionTextToFrame(image_and_ROI, emotion_prediction);
             std::cout << "it should be " << emotion_prediction[0] << std::endl
                       << "also could be " << emotion_prediction_2 << std::endl;
         }
 
-        cv::Mat output_frame = image_and_ROI.getFrame();
-
-        if (!output_frame.empty()) {
-            // Отображение видеокадра в окне
-            imshow(APP_NAME, output_frame);
-        } else {
-            // Если выходной кадр пуст (например, детектор лиц не обнаружил ничего), просто отображаем оригинальное видео
-            imshow(APP_NAME, frame);
-        }
+        // Отображение кадра с рамками и текстом предсказания в окне
+        FrameRenderer renderer;
+        imshow(APP_NAME, renderer.render(frame, faces, FaceQuality::labelFaces(scores, emotion_prediction)));
 
         // Ожидание нажатия любой клавиши в течение 10 мс.
         // Если нажата клавиша 'Esc', выход из программы
@@ -201,65 +656,7 @@ int main()
 
         return 0;
     } if(anser == 1){
-        cv::Mat frame;
-        // Инициализация всех необходимых объектов
-        Model model(TENSORFLOW_MODEL_PATH);
-        FaceDetector face_detector;
-        Image image_and_ROI;
-
-        // Инициализация объекта захвата видео с использованием камеры по умолчанию
-        cv::VideoCapture cap(0);
-        // Создание окна с названием приложения
-        cv::namedWindow(APP_NAME);
-
-        // Главный цикл программы
-        while (true) {
-            // Считывание нового кадра с видео
-            bool bSuccess = cap.read(frame);
-// Прерывание цикла, если не удается захватить кадры
-            if (!bSuccess) {
-                std::cout << "Video camera is disconnected. Stopping the program" << std::endl;
-                std::cin.get(); // Ожидание нажатия любой клавиши
-                break;
-            }
-
-            // Выполнение детекции лиц и рисование рамок
-            face_detector.detectFace(frame);
-
-            // Рисование рамок на изображении
-            image_and_ROI = face_detector.drawBoundingBoxOnFrame(frame);
-
-            // Получение областей интереса (ROI)
-            std::vector<cv::Mat> roi_image = image_and_ROI.getROI();
-
-            if (roi_image.size() > 0) {
-                // Предобработка изображения для модели
-                image_and_ROI.preprocessROI();
-                // Выполнение предсказания
-                std::vector<std::string> emotion_prediction = model.predict(image_and_ROI);
-                // Добавление текста предсказания на изображение
-                image_and_ROI = face_detector.printPredictionTextToFrame(image_and_ROI, emotion_prediction);
-            }
-
-            cv::Mat output_frame = image_and_ROI.getFrame();
-
-            if (!output_frame.empty()) {
-                // Отображение видеокадра в окне
-                imshow(APP_NAME, output_frame);
-            } else {
-                // Если выходной кадр пуст (например, детектор лиц не обнаружил ничего), просто отображаем оригинальное видео
-                imshow(APP_NAME, frame);
-            }
-
-            // Ожидание нажатия любой клавиши в течение 10 мс.
-            // Если нажата клавиша 'Esc', выход из программы
-            if (cv::waitKey(100) == 27) {
-                std::cout << "Esc key is pressed by user. Stopping the program" << std::endl;
-                break;
-            }
-        }
-
-        return 0;
+        return runCamera(options, bundle);
     }
     if (anser == 2) {
 
@@ -271,42 +668,67 @@ int main()
         Video mp(cap);
         std::vector<std::string> spectrum;
 
-        for(double time = 0; time < mp.getLengthInSeconds(); time = time + 1.0) {
-          cv::Mat frame = mp[time];
-          // Инициализация всех необходимых объектов
-          Model model(TENSORFLOW_MODEL_PATH);
-          FaceDetector face_detector;
-          Image image_and_ROI;
-          std::string nnn{};
-          // Выполнение детекции лиц и рисование рамок
-          face_detector.detectFace(frame);
-
-          // Рисование рамок на изображении
-          image_and_ROI = face_detector.drawBoundingBoxOnFrame(frame);
-
-          // Получение областей интереса (ROI)
-          std::vector<cv::Mat> roi_image = image_and_ROI.getROI();
-
-          if (roi_image.size() > 0) {
-              // Предобработка изображения для модели
-              image_and_ROI.preprocessROI();
-              // Выполнение предсказания
-              std::vector<std::string> emotion_prediction = model.predict(image_and_ROI);
-              // Добавление текста предсказания на изображение
-              image_and_ROI = face_detector.printPredictionTextToFrame(image_and_ROI, emotion_prediction);
-
-              for(auto a : emotion_prediction[0]) {
-
-                if(a == ':'){
-                  break;
-                }
-                nnn = nnn + a;
+        // Инициализация всех необходимых объектов
+        Model model = loadModel(bundle);
+        FaceDetector face_detector = loadFaceDetector(bundle);
+        configureFaceDetector(face_detector, options);
+        FramePool frame_pool(1);
+        FramePool::Frame pooled_frame = frame_pool.acquire();
+
+        MotionSampler::Settings sampler_settings;
+        if (options.every_second) {
+            sampler_settings.threshold = -1;
+            sampler_settings.dense_window = 0;
+        }
+        MotionSampler sampler(sampler_settings);
 
+        // Хранилище результатов перезаписывается: видео обрабатывается с начала
+        ResultStoreWriter results;
+        if (!options.results_path.empty() && !results.open(options.results_path, Model::classCount(), 0.0)) {
+            return 1;
+        }
+
+        // Гистограмма и график строятся по одной записи на секунду видео: на пропущенные
+        // кадры переносится последнее предсказание
+        FrameClassifier classifier(face_detector, [&model](Image& image) { return model.classify(image); },
+                                   options.quality_gate);
+        int last_class = -1;
+        double next_record = 0;
+
+        for(double time = 0; time < mp.getLengthInSeconds(); time = time + sampler.nextInterval()) {
+          // Кадр читается в один и тот же буфер без выделения памяти
+          cv::Mat& frame = pooled_frame.mat();
+          if (!mp.read(time, frame)) {
+            continue;
+          }
+
+          if (sampler.shouldProcess(frame, time)) {
+            // Детекция, оценка качества и предсказание пригодных лиц. Если все лица непригодны,
+            // секунда не попадает в гистограмму вместо случайной метки
+            last_class = classifier.classify(frame);
+            printSkippedFaces(classifier.scores());
+
+            // Предсказания идут в порядке принятых оценкой качества лиц
+            const std::vector<EmotionPrediction>& predictions = classifier.predictions();
+            if (!options.results_path.empty()) {
+              uint32_t frame_number = static_cast<uint32_t>(std::max(0.0, cap.get(cv::CAP_PROP_POS_FRAMES) - 1));
+              for (size_t i = 0; i < predictions.size() && i < classifier.faces().size(); i++) {
+                results.append(time, frame_number, classifier.faces()[i], predictions[i]);
               }
-              std::cout<<emotion_prediction[0]<<std::endl;
-              spectrum.push_back(nnn);
+            }
+            if (!predictions.empty()) {
+              std::cout << Model::formatPrediction(predictions[0]) << std::endl;
+            }
+          }
+
+          for (size_t n = FrameClassifier::recordSeconds(time, next_record); n > 0 && last_class >= 0; n--) {
+            spectrum.push_back(Model::className(last_class));
           }
         }
+      if (!options.results_path.empty()) {
+        results.close();
+        std::cout << results.size() << " face results saved to " << options.results_path << std::endl;
+      }
       std::cout<<"Histogram of frequency"<<std::endl;
       printHistogram(spectrum);
       
@@ -321,5 +743,3 @@ int main()
     }
     return 0;
 }
-
-#endif
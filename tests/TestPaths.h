@@ -0,0 +1,79 @@
+/**
+ * @file TestPaths.h
+ * @brief Уникальные имена временных файлов, каталогов и колец для тестов.
+ * Имена содержат pid процесса, чтобы параллельные запуски тестов не мешали друг другу.
+ */
+
+#ifndef TESTPATHS_H
+#define TESTPATHS_H
+
+#include <unistd.h>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+/**
+ * @brief Уникальное имя для временного объекта теста.
+ * @param prefix Префикс имени.
+ * @param suffix Окончание имени, включая расширение.
+ * @return Имя вида prefix_pid_suffix.
+ */
+inline std::string testName(const std::string& prefix, const std::string& suffix) {
+    return prefix + "_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+/**
+ * @brief Уникальное имя кольца в разделяемой памяти. Кольцо удаляет создавший его SharedFrameRing.
+ * @param suffix Окончание имени.
+ * @return Имя кольца.
+ */
+inline std::string testRingName(const std::string& suffix) {
+    return "/" + testName("emotion_test", suffix);
+}
+
+/**
+ * @struct TemporaryFile
+ * @brief Уникальный путь во временном каталоге. Файл удаляется при создании и деструктором,
+ * в том числе, если проверка теста не прошла.
+ */
+struct TemporaryFile {
+    std::string path; ///< Путь к файлу.
+
+    TemporaryFile(const std::string& prefix, const std::string& suffix)
+        : path((std::filesystem::temp_directory_path() / testName(prefix, suffix)).string()) {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    ~TemporaryFile() {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+};
+
+/**
+ * @struct TemporaryDirectory
+ * @brief Уникальный пустой временный каталог, удаляемый деструктором вместе с содержимым.
+ */
+struct TemporaryDirectory {
+    std::filesystem::path path; ///< Путь к каталогу.
+
+    explicit TemporaryDirectory(const std::string& prefix)
+        : path(std::filesystem::temp_directory_path() / testName(prefix, "dir")) {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+
+    ~TemporaryDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+};
+
+#endif
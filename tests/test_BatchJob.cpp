@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "BatchJob.h"
+#include "TestPaths.h"
+
+/**
+ * @brief Записывает файл заданного содержимого.
+ */
+static std::string writeFile(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output << content;
+    return path.string();
+}
+
+TEST_CASE("BatchJob round-trips progress through an atomic checkpoint") {
+    TemporaryDirectory directory("emotion_batch_test");
+    std::string manifest = (directory.path / "job.manifest").string();
+    std::string first = writeFile(directory.path / "first video.mp4", "first");
+    std::string second = writeFile(directory.path / "second.mp4", "second");
+
+    BatchJob job(manifest, 7);
+    REQUIRE(job.load());
+    REQUIRE(job.entries().empty());
+    REQUIRE(job.addFiles({first, second, first}) == 2);
+
+    BatchJob::Entry& entry = job.entries()[0];
+    entry.status = BatchJob::RUNNING;
+    entry.attempts = 1;
+    entry.position = 125.25;
+    entry.next_record = 126.0;
+    entry.last_class = 3;
+    entry.class_seconds[3] = 100;
+    entry.class_seconds[6] = 26;
+    job.entries()[1].status = BatchJob::DONE;
+    REQUIRE(job.save());
+    REQUIRE_FALSE(std::filesystem::exists(manifest + ".tmp"));
+
+    BatchJob resumed(manifest, 7);
+    REQUIRE(resumed.load());
+    REQUIRE(resumed.entries().size() == 2);
+
+    const BatchJob::Entry& restored = resumed.entries()[0];
+    REQUIRE(restored.path == first);
+    REQUIRE(restored.status == BatchJob::RUNNING);
+    REQUIRE(restored.attempts == 1);
+    REQUIRE(restored.position == 125.25);
+    REQUIRE(restored.next_record == 126.0);
+    REQUIRE(restored.last_class == 3);
+    REQUIRE(restored.class_seconds[3] == 100);
+    REQUIRE(restored.class_seconds[6] == 26);
+
+    // Прерванный файл продолжается, обработанный пропускается
+    REQUIRE(BatchJob::needsWork(restored, 3));
+    REQUIRE_FALSE(BatchJob::needsWork(resumed.entries()[1], 3));
+    REQUIRE_FALSE(BatchJob::needsWork(restored, 1));
+}
+
+TEST_CASE("BatchJob requeues only new and changed files") {
+    TemporaryDirectory directory("emotion_batch_test");
+    std::string manifest = (directory.path / "job.manifest").string();
+    std::string unchanged = writeFile(directory.path / "unchanged.mp4", "same");
+    std::string changed = writeFile(directory.path / "changed.mp4", "old");
+
+    BatchJob job(manifest, 7);
+    REQUIRE(job.addFiles({unchanged, changed}) == 2);
+    for (BatchJob::Entry& entry : job.entries()) {
+        entry.status = BatchJob::DONE;
+        entry.position = 60.0;
+    }
+    REQUIRE(job.save());
+
+    writeFile(directory.path / "changed.mp4", "new and longer");
+    std::string added = writeFile(directory.path / "added.mp4", "added");
+
+    BatchJob nightly(manifest, 7);
+    REQUIRE(nightly.load());
+    REQUIRE(nightly.addFiles({unchanged, changed, added}) == 2);
+    REQUIRE(nightly.entries()[0].status == BatchJob::DONE);
+    REQUIRE(nightly.entries()[1].status == BatchJob::PENDING);
+    REQUIRE(nightly.entries()[1].position == 0.0);
+    REQUIRE(nightly.entries()[2].path == added);
+}
+
+TEST_CASE("BatchJob rejects a corrupted manifest") {
+    TemporaryDirectory directory("emotion_batch_test");
+    std::string manifest = writeFile(directory.path / "job.manifest",
+                                     "# emotion batch manifest v1\ndone\t1\t2\tthree\n");
+    BatchJob job(manifest, 7);
+    REQUIRE_FALSE(job.load());
+
+    writeFile(directory.path / "job.manifest", "not a manifest\n");
+    REQUIRE_FALSE(job.load());
+}
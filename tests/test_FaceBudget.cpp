@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include "FaceBudget.h"
+
+/**
+ * @brief Размер тестового кадра.
+ */
+static const cv::Size FRAME_SIZE(640, 480);
+
+/**
+ * @brief Три лица: маленькое в центре, крупное в углу, среднее рядом с центром.
+ */
+static std::vector<cv::Rect> testFaces() {
+    return {cv::Rect(300, 220, 40, 40), cv::Rect(10, 10, 200, 200), cv::Rect(400, 250, 100, 100)};
+}
+
+/**
+ * @brief Выполняет предсказания для лиц в порядке бюджета, пока он позволяет.
+ * @return Подписи всех лиц кадра.
+ */
+static std::vector<std::string> runFrame(FaceBudget& budget, const std::vector<cv::Rect>& faces,
+                                         const std::string& label) {
+    size_t inferred = 0;
+    for (size_t face : budget.rank(faces, FRAME_SIZE)) {
+        if (!budget.allows(inferred, 0.0)) {
+            break;
+        }
+        budget.setLabel(face, label + std::to_string(face));
+        inferred++;
+    }
+    return budget.labels();
+}
+
+TEST_CASE("FaceBudget orders faces by the configured priority") {
+    FaceBudget::Settings settings;
+
+    settings.priority = FaceBudget::LARGEST;
+    FaceBudget largest(settings);
+    std::vector<size_t> by_size = largest.rank(testFaces(), FRAME_SIZE);
+    std::vector<size_t> expected_size = {1, 2, 0};
+    REQUIRE(by_size == expected_size);
+
+    settings.priority = FaceBudget::CENTRAL;
+    FaceBudget central(settings);
+    std::vector<size_t> by_center = central.rank(testFaces(), FRAME_SIZE);
+    std::vector<size_t> expected_center = {0, 2, 1};
+    REQUIRE(by_center == expected_center);
+
+    // Лицо, появившееся позже, идёт после лиц, которые уже были в кадре
+    settings.priority = FaceBudget::OLDEST;
+    FaceBudget oldest(settings);
+    std::vector<cv::Rect> faces = testFaces();
+    std::vector<cv::Rect> first_frame = {faces[1]};
+    oldest.rank(first_frame, FRAME_SIZE);
+    std::vector<size_t> by_age = oldest.rank(faces, FRAME_SIZE);
+    REQUIRE(by_age[0] == 1);
+
+    FaceBudget::Priority priority;
+    REQUIRE(FaceBudget::parsePriority("central", priority));
+    REQUIRE(priority == FaceBudget::CENTRAL);
+    REQUIRE_FALSE(FaceBudget::parsePriority("smallest", priority));
+}
+
+TEST_CASE("FaceBudget limits predictions by count and projected time") {
+    FaceBudget::Settings settings;
+    settings.max_faces = 2;
+    FaceBudget by_count(settings);
+    REQUIRE(by_count.allows(0, 0.0));
+    REQUIRE(by_count.allows(1, 0.0));
+    REQUIRE_FALSE(by_count.allows(2, 0.0));
+
+    settings.max_faces = 0;
+    settings.max_ms = 10.0;
+    FaceBudget by_time(settings);
+    // Первое предсказание выполняется всегда, следующие - пока оценка времени укладывается в бюджет
+    REQUIRE(by_time.allows(0, 50.0));
+    REQUIRE(by_time.allows(2, 6.0));
+    REQUIRE_FALSE(by_time.allows(2, 8.0));
+
+    FaceBudget unlimited;
+    REQUIRE(unlimited.allows(1000, 1000.0));
+
+    // Ограничение регулятора качества действует вместе с настройкой: применяется меньшее
+    settings.max_faces = 3;
+    settings.max_ms = 0.0;
+    FaceBudget limited(settings);
+    limited.setFrameLimit(1);
+    REQUIRE_FALSE(limited.allows(1, 0.0));
+    limited.setFrameLimit(5);
+    REQUIRE(limited.allows(2, 0.0));
+    REQUIRE_FALSE(limited.allows(3, 0.0));
+    limited.setFrameLimit(0);
+    REQUIRE(limited.allows(2, 0.0));
+}
+
+TEST_CASE("FaceBudget carries predictions forward and marks new faces pending") {
+    FaceBudget::Settings settings;
+    settings.max_faces = 1;
+    settings.max_wait_frames = 100;
+    FaceBudget budget(settings);
+    std::vector<cv::Rect> faces = testFaces();
+
+    std::vector<cv::Rect> first = {faces[2]};
+    std::vector<std::string> labels = runFrame(budget, first, "a");
+    REQUIRE(labels.size() == 1);
+    REQUIRE(labels[0] == "a0");
+
+    // Появились крупное и маленькое лица, рамки сдвинулись и пришли в другом порядке:
+    // предсказание получает крупное лицо, прошлая подпись следует за своим треком
+    std::vector<cv::Rect> second = {faces[0], faces[2] + cv::Point(5, 5), faces[1]};
+    labels = runFrame(budget, second, "b");
+    REQUIRE(labels.size() == 3);
+    REQUIRE(labels[2] == "b2");
+    REQUIRE(labels[1] == "a0");
+    REQUIRE(labels[0] == FaceBudget::PENDING_LABEL);
+
+    REQUIRE(budget.inferredFaces() == 2);
+    REQUIRE(budget.carriedFaces() == 1);
+    REQUIRE(budget.pendingFaces() == 1);
+
+    // Лица нового кадра без предыдущего не наследуют подписи
+    std::vector<cv::Rect> elsewhere = {cv::Rect(0, 300, 50, 50)};
+    labels = runFrame(budget, elsewhere, "c");
+    REQUIRE(labels[0] == "c0");
+}
+
+TEST_CASE("FaceBudget rotates predictions through faces waiting too long") {
+    FaceBudget::Settings settings;
+    settings.max_faces = 1;
+    settings.max_wait_frames = 2;
+    FaceBudget budget(settings);
+    std::vector<cv::Rect> faces = testFaces();
+
+    // Без ожидания крупное лицо получало бы предсказание на каждом кадре
+    std::vector<bool> labeled(faces.size(), false);
+    for (int frame = 0; frame < 6; frame++) {
+        std::vector<std::string> labels = runFrame(budget, faces, "f" + std::to_string(frame) + "_");
+        for (size_t i = 0; i < labels.size(); i++) {
+            labeled[i] = labeled[i] || labels[i] != FaceBudget::PENDING_LABEL;
+        }
+    }
+    for (bool value : labeled) {
+        REQUIRE(value);
+    }
+    REQUIRE(budget.carriedFaces() > 0);
+}
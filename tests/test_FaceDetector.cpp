@@ -1,7 +1,4 @@
-#pragma once
-
-#define CATCH_CONFIG_MAIN
-#include "../contrib/catch/catch.hpp"
+#include <catch2/catch_test_macros.hpp>
 
 #include <filesystem>
 #include <opencv2/opencv.hpp>
@@ -14,19 +11,18 @@
 #include <filesystem>
 
 
-#include "../src/Image.h"
-#include "../src/FaceDetector.h"
-#include "../src/Model.h"
+#include "Image.h"
+#include "FaceDetector.h"
+#include "FrameRenderer.h"
+#include "Model.h"
 
 const std::string FACE_DETECTOR_MODEL_PATH = "model/haarcascade_frontalface_alt2.xml";
 const std::string TENSORFLOW_MODEL_PATH = "model/tensorflow_model.pb";
-const std::string APP_NAME = "Real-Time Facial Emotion Recognition";
-const std::string WAY = "";
 
 TEST_CASE("Testing FaceDetector") {
     std::filesystem::path test_path = "src/image.jpg";
     std::filesystem::path error_test_path = "src/error_image.jpg";
-    FaceDetector faceDetector;
+    FaceDetector faceDetector(FACE_DETECTOR_MODEL_PATH);
 
     SECTION("Test detectFace with a simple image") {
         cv::Mat test_image = cv::imread(test_path);
@@ -44,29 +40,37 @@ TEST_CASE("Testing FaceDetector") {
         CHECK(faceDetector.faceCount() == 0);
     }
 
-    SECTION("Test drawBoundingBoxOnFrame") {
+    SECTION("Test extractROI") {
         cv::Mat test_image = cv::imread(test_path);
         REQUIRE_FALSE(test_image.empty());
+        cv::Mat original = test_image.clone();
 
         faceDetector.detectFace(test_image);
-        Image result_image = faceDetector.drawBoundingBoxOnFrame(test_image);
-
-        cv::Mat frame_with_boxes = result_image.getFrame();
-        CHECK_FALSE(frame_with_boxes.empty());
+        Image result_image = faceDetector.extractROI(test_image);
+
+        CHECK_FALSE(result_image.getFrame().empty());
+        CHECK(result_image.getROI().size() == faceDetector.faceCount());
+        for (const cv::Mat& roi : result_image.getROI()) {
+            CHECK(roi.channels() == 1);
+        }
+        CHECK(cv::norm(test_image, original, cv::NORM_L1) == 0);
     }
 
-    SECTION("Test printPredictionTextToFrame") {
+    SECTION("Test FrameRenderer") {
         cv::Mat test_image = cv::imread(test_path);
         REQUIRE_FALSE(test_image.empty());
+        cv::Mat original = test_image.clone();
 
-        faceDetector.detectFace(test_image);
-        Image result_image = faceDetector.drawBoundingBoxOnFrame(test_image);
+        std::vector<cv::Rect> faces = faceDetector.detectFace(test_image);
         std::vector<std::string> predictions = {"Happy"};
 
-        Image image_with_text = faceDetector.printPredictionTextToFrame(result_image, predictions);
-
-        cv::Mat frame_with_text = image_with_text.getFrame();
+        FrameRenderer renderer;
+        cv::Mat frame_with_text = renderer.render(test_image, faces, predictions);
         CHECK_FALSE(frame_with_text.empty());
+        CHECK(cv::norm(test_image, original, cv::NORM_L1) == 0);
+
+        renderer.setEnabled(false);
+        CHECK(renderer.render(test_image, faces, predictions).data == test_image.data);
     }
 }
 
@@ -74,14 +78,14 @@ TEST_CASE("Testing FaceDetector full pipeline main emotion") {
     std::filesystem::path test_path = "src/image.jpg";
 
     Model model(TENSORFLOW_MODEL_PATH);
-    FaceDetector face_detector;
+    FaceDetector face_detector(FACE_DETECTOR_MODEL_PATH);
     Image image_and_ROI;
     cv::Mat frame;
 
     frame = cv::imread(test_path);
 
     face_detector.detectFace(frame);
-    image_and_ROI = face_detector.drawBoundingBoxOnFrame(frame);
+    image_and_ROI = face_detector.extractROI(frame);
 
     std::vector<cv::Mat> roi_image = image_and_ROI.getROI();
 
@@ -90,8 +94,6 @@ TEST_CASE("Testing FaceDetector full pipeline main emotion") {
 
         std::vector<std::string> emotion_prediction = model.predict(image_and_ROI);
         std::string emotion_prediction_2 = model.ans(image_and_ROI);
-
-        image_and_ROI = face_detector.printPredictionTextToFrame(image_and_ROI, emotion_prediction);
         
         REQUIRE(emotion_prediction[0].find("Happy") != std::string::npos);
     } else {
@@ -103,7 +105,7 @@ TEST_CASE("Testing FaceDetector full pipeline second emotion") {
     std::filesystem::path test_path = "src/image.jpg";
 
     Model model(TENSORFLOW_MODEL_PATH);
-    FaceDetector face_detector;
+    FaceDetector face_detector(FACE_DETECTOR_MODEL_PATH);
     Image image_and_ROI;
     cv::Mat frame;
 
@@ -111,7 +113,7 @@ TEST_CASE("Testing FaceDetector full pipeline second emotion") {
 
     face_detector.detectFace(frame);
 
-    image_and_ROI = face_detector.drawBoundingBoxOnFrame(frame);
+    image_and_ROI = face_detector.extractROI(frame);
 
     std::vector<cv::Mat> roi_image = image_and_ROI.getROI();
 
@@ -120,8 +122,6 @@ TEST_CASE("Testing FaceDetector full pipeline second emotion") {
 
         std::vector<std::string> emotion_prediction = model.predict(image_and_ROI);
         std::string emotion_prediction_2 = model.ans(image_and_ROI);
-
-        image_and_ROI = face_detector.printPredictionTextToFrame(image_and_ROI, emotion_prediction);
         
         REQUIRE(emotion_prediction_2.find("Neutral") != std::string::npos);
     } else {
@@ -132,7 +132,7 @@ TEST_CASE("Testing FaceDetector full pipeline second emotion") {
 TEST_CASE("FaceDetector loads model and detects faces") {
     std::filesystem::path test_path = "src/image.jpg";
     std::filesystem::path error_test_path = "src/error_image.jpg";
-    FaceDetector faceDetector;
+    FaceDetector faceDetector(FACE_DETECTOR_MODEL_PATH);
 
     SECTION("Correct image") {
         cv::Mat testImage = cv::imread(test_path);
@@ -141,12 +141,12 @@ TEST_CASE("FaceDetector loads model and detects faces") {
         faceDetector.detectFace(testImage);
         REQUIRE(faceDetector.faceCount() > 0);
 
-        Image resultImage = faceDetector.drawBoundingBoxOnFrame(testImage);
+        Image resultImage = faceDetector.extractROI(testImage);
         REQUIRE(!resultImage.getFrame().empty());
 
         std::vector<std::string> emotions = {"happy", "sad"};
-        Image finalImage = faceDetector.printPredictionTextToFrame(resultImage, emotions);
-        REQUIRE(!finalImage.getFrame().empty());
+        FrameRenderer renderer;
+        REQUIRE(!renderer.render(testImage, faceDetector.getFaces(), emotions).empty());
     }
 
     SECTION("Incorrect image") {
@@ -246,4 +246,28 @@ TEST_CASE("Model loads and makes predictions") {
         REQUIRE(answer.empty());
 
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Tiled detection matches the untiled path") {
+    std::filesystem::path test_path = "src/image.jpg";
+    cv::Mat frame = cv::imread(test_path);
+    REQUIRE(!frame.empty());
+
+    FaceDetector untiled(FACE_DETECTOR_MODEL_PATH);
+    std::vector<cv::Rect> expected = untiled.detectFace(frame);
+    REQUIRE(expected.size() > 0);
+
+    FaceDetector tiled(FACE_DETECTOR_MODEL_PATH);
+    tiled.setTiling(4, cv::Size(400, 400), 0);
+    std::vector<cv::Rect> actual = tiled.detectFace(frame);
+
+    REQUIRE(actual.size() == expected.size());
+    for (const cv::Rect& face : actual) {
+        bool matched = false;
+        for (const cv::Rect& reference : expected) {
+            double intersection = (face & reference).area();
+            matched = matched || intersection / (face | reference).area() > 0.7;
+        }
+        CHECK(matched);
+    }
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "FaceDetector.h"
+#include "FaceQuality.h"
+
+/**
+ * @brief Резкое изображение лица-заглушки: мелкая шахматная доска.
+ */
+static cv::Mat sharpFace(int size) {
+    cv::Mat face(size, size, CV_8UC1);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            face.at<uchar>(y, x) = ((x / 4 + y / 4) % 2) ? 220 : 30;
+        }
+    }
+    return face;
+}
+
+TEST_CASE("FaceQuality rejects unusable crops with a reason") {
+    FaceQuality quality;
+    cv::Size frame_size(640, 480);
+    cv::Rect inside(200, 150, 120, 120);
+
+    SECTION("A sharp, contrasted face in the middle of the frame is accepted") {
+        FaceQuality::Score score = quality.evaluate(sharpFace(120), inside, frame_size);
+        REQUIRE(score.accepted());
+        REQUIRE(score.contrast > 12.0);
+        REQUIRE(score.sharpness > 15.0);
+    }
+
+    SECTION("Small faces are rejected") {
+        FaceQuality::Score score = quality.evaluate(sharpFace(30), cv::Rect(200, 150, 30, 30), frame_size);
+        REQUIRE(score.reason == FaceQuality::TOO_SMALL);
+    }
+
+    SECTION("Faces touching the frame border are rejected") {
+        FaceQuality::Score score = quality.evaluate(sharpFace(120), cv::Rect(0, 150, 120, 120), frame_size);
+        REQUIRE(score.reason == FaceQuality::TRUNCATED);
+        score = quality.evaluate(sharpFace(120), cv::Rect(520, 360, 120, 120), frame_size);
+        REQUIRE(score.reason == FaceQuality::TRUNCATED);
+    }
+
+    SECTION("Flat crops are rejected as low contrast") {
+        cv::Mat flat(120, 120, CV_8UC1, cv::Scalar(128));
+        REQUIRE(quality.evaluate(flat, inside, frame_size).reason == FaceQuality::LOW_CONTRAST);
+    }
+
+    SECTION("Blurred crops are rejected as blurry") {
+        // Плавный градиент: контраст есть, деталей нет
+        cv::Mat gradient(120, 120, CV_8UC1);
+        for (int y = 0; y < 120; y++) {
+            for (int x = 0; x < 120; x++) {
+                gradient.at<uchar>(y, x) = static_cast<uchar>(x * 2);
+            }
+        }
+        cv::Mat blurred;
+        cv::GaussianBlur(gradient, blurred, cv::Size(31, 31), 10);
+
+        FaceQuality::Score score = quality.evaluate(blurred, inside, frame_size);
+        REQUIRE(score.reason == FaceQuality::BLURRY);
+        REQUIRE(FaceQuality::reasonName(score.reason) == "blurry");
+    }
+}
+
+TEST_CASE("FaceQuality::labelFaces keeps labels aligned with face boxes") {
+    std::vector<FaceQuality::Score> scores(3);
+    scores[1].reason = FaceQuality::BLURRY;
+
+    std::vector<std::string> labels = FaceQuality::labelFaces(scores, {"Happy: 90%", "Sad: 70%"});
+
+    REQUIRE(labels.size() == 3);
+    REQUIRE(labels[0] == "Happy: 90%");
+    REQUIRE(labels[1] == "skipped: blurry");
+    REQUIRE(labels[2] == "Sad: 70%");
+}
+
+TEST_CASE("FaceDetector::extractROI with a quality gate keeps the test face") {
+    FaceDetector face_detector("model/haarcascade_frontalface_alt2.xml");
+    FaceQuality quality;
+    cv::Mat frame = cv::imread("src/image.jpg");
+    REQUIRE(!frame.empty());
+
+    face_detector.detectFace(frame);
+    std::vector<FaceQuality::Score> scores;
+    Image image_and_ROI = face_detector.extractROI(frame, quality, scores);
+
+    REQUIRE(scores.size() == face_detector.faceCount());
+    size_t accepted = 0;
+    for (const FaceQuality::Score& score : scores) {
+        accepted += score.accepted() ? 1 : 0;
+    }
+    REQUIRE(accepted > 0);
+    REQUIRE(image_and_ROI.getROI().size() == accepted);
+}
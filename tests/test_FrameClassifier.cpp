@@ -0,0 +1,46 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <opencv2/imgcodecs.hpp>
+#include <string>
+#include <vector>
+
+#include "FaceDetector.h"
+#include "FrameClassifier.h"
+
+TEST_CASE("FrameClassifier records one entry per second of video") {
+    double next_record = 0.0;
+    REQUIRE(FrameClassifier::recordSeconds(0.0, next_record) == 1);
+    REQUIRE(FrameClassifier::recordSeconds(0.5, next_record) == 0);
+
+    // Пропущенные кадры получают класс последнего обработанного кадра
+    REQUIRE(FrameClassifier::recordSeconds(3.2, next_record) == 3);
+    REQUIRE(next_record == 4.0);
+    REQUIRE(FrameClassifier::recordSeconds(4.0, next_record) == 1);
+}
+
+TEST_CASE("FrameClassifier predicts every accepted face in frame order") {
+    cv::Mat frame = cv::imread("src/image.jpg");
+    REQUIRE_FALSE(frame.empty());
+
+    FaceDetector face_detector("model/haarcascade_frontalface_alt2.xml");
+    size_t predicted = 0;
+    FrameClassifier classifier(face_detector, [&predicted](Image& image) {
+        std::vector<EmotionPrediction> predictions(image.getModelInput().size());
+        for (EmotionPrediction& prediction : predictions) {
+            prediction.class_id = 4;
+        }
+        predicted += predictions.size();
+        return predictions;
+    }, false);
+
+    REQUIRE(classifier.classify(frame) == 4);
+    REQUIRE(predicted > 0);
+    REQUIRE(classifier.faces().size() == predicted);
+    REQUIRE(classifier.predictions().size() == predicted);
+    REQUIRE(classifier.scores().size() == face_detector.faceCount());
+
+    // Кадр без лиц не получает класса
+    REQUIRE(classifier.classify(cv::Mat(240, 320, CV_8UC3, cv::Scalar(0, 0, 0))) == -1);
+    REQUIRE(classifier.faces().empty());
+    REQUIRE(classifier.predictions().empty());
+}
@@ -0,0 +1,50 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <opencv2/core.hpp>
+#include <chrono>
+
+#include "FramePool.h"
+
+TEST_CASE("FramePool recycles preallocated frames") {
+    FramePool pool(2, cv::Size(64, 48), CV_8UC3);
+    REQUIRE(pool.capacity() == 2);
+    REQUIRE(pool.available() == 2);
+
+    SECTION("Frames keep their buffers between acquisitions") {
+        uchar* data = nullptr;
+        {
+            FramePool::Frame frame = pool.acquire();
+            REQUIRE_FALSE(frame.empty());
+            REQUIRE(frame.mat().rows == 48);
+            data = frame.mat().data;
+            REQUIRE(pool.available() == 1);
+        }
+        REQUIRE(pool.available() == 2);
+
+        FramePool::Frame first = pool.acquire();
+        CHECK(first.mat().data == data);
+    }
+
+    SECTION("Copies keep the frame out of the pool until the last one is released") {
+        FramePool::Frame frame = pool.acquire();
+        FramePool::Frame copy = frame;
+        frame.release();
+        CHECK(pool.available() == 1);
+
+        copy.release();
+        CHECK(pool.available() == 2);
+    }
+
+    SECTION("Exhausted pool applies backpressure") {
+        FramePool::Frame a = pool.acquire();
+        FramePool::Frame b = pool.acquire();
+
+        FramePool::Frame c;
+        CHECK_FALSE(pool.tryAcquire(c, std::chrono::milliseconds(10)));
+        CHECK(c.empty());
+
+        a.release();
+        CHECK(pool.tryAcquire(c, std::chrono::milliseconds(10)));
+        CHECK_FALSE(c.empty());
+    }
+}
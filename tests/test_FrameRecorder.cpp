@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include "FrameRecorder.h"
+#include "ReplaySource.h"
+#include "TestPaths.h"
+
+/**
+ * @brief Кадр 32x24 с градиентом, зависящим от номера кадра.
+ */
+static cv::Mat testFrame(int index, int type) {
+    cv::Mat frame(24, 32, type);
+    for (int y = 0; y < frame.rows; y++) {
+        for (int x = 0; x < frame.cols * frame.channels(); x++) {
+            frame.ptr<uchar>(y)[x] = static_cast<uchar>(index * 10 + x + y);
+        }
+    }
+    return frame;
+}
+
+/**
+ * @brief Проверяет, что два кадра совпадают попиксельно.
+ */
+static bool sameFrame(const cv::Mat& a, const cv::Mat& b) {
+    return a.size() == b.size() && a.type() == b.type() && cv::norm(a, b, cv::NORM_INF) == 0;
+}
+
+TEST_CASE("ReplaySource reproduces recorded frames and timestamps exactly") {
+    TemporaryFile recording("emotion_recording", "exact.rec");
+    const std::string& path = recording.path;
+
+    // YUYV с камеры без конвертации PNG не поддерживает, такие кадры пишутся без сжатия
+    for (int type : {CV_8UC3, CV_8UC1, CV_8UC2}) {
+        for (RecordingCodec codec : {RECORDING_RAW, RECORDING_PNG}) {
+            FrameRecorder recorder(path, codec);
+            REQUIRE(recorder.isOpen());
+            for (int i = 0; i < 5; i++) {
+                REQUIRE(recorder.write(testFrame(i, type), 1.5 + i * 0.04));
+            }
+            REQUIRE(recorder.close());
+            REQUIRE(recorder.frameCount() == 5);
+
+            for (bool preload : {false, true}) {
+                ReplaySource replay(path, ReplaySource::MAX_SPEED, preload);
+                REQUIRE(replay.isOpened());
+                REQUIRE(replay.get(cv::CAP_PROP_FRAME_COUNT) == 5);
+                REQUIRE(replay.get(cv::CAP_PROP_FRAME_WIDTH) == 32);
+                REQUIRE(replay.get(cv::CAP_PROP_FRAME_HEIGHT) == 24);
+
+                cv::Mat frame;
+                for (int i = 0; i < 5; i++) {
+                    REQUIRE(replay.read(frame));
+                    REQUIRE(sameFrame(frame, testFrame(i, type)));
+                    REQUIRE(replay.timestamp() == 1.5 + i * 0.04);
+                }
+                REQUIRE_FALSE(replay.read(frame));
+                REQUIRE(replay.framesRead() == 5);
+            }
+        }
+    }
+}
+
+TEST_CASE("ReplaySource paces frames at the recorded speed") {
+    TemporaryFile recording("emotion_recording", "pace.rec");
+    const std::string& path = recording.path;
+    {
+        FrameRecorder recorder(path);
+        for (int i = 0; i < 4; i++) {
+            recorder.write(testFrame(i, CV_8UC1), i * 0.05);
+        }
+    }
+
+    ReplaySource replay(path, ReplaySource::RECORDED_SPEED);
+    REQUIRE(replay.get(cv::CAP_PROP_FPS) == 20.0);
+
+    cv::Mat frame;
+    auto started = std::chrono::steady_clock::now();
+    while (replay.read(frame)) {
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    REQUIRE(elapsed >= 0.15);
+}
+
+TEST_CASE("ReplaySource plays a truncated recording up to the last whole frame") {
+    TemporaryFile recording("emotion_recording", "truncated.rec");
+    const std::string& path = recording.path;
+    {
+        FrameRecorder recorder(path);
+        for (int i = 0; i < 3; i++) {
+            recorder.write(testFrame(i, CV_8UC1), i);
+        }
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 10);
+
+    ReplaySource replay(path, ReplaySource::MAX_SPEED);
+    REQUIRE(replay.isOpened());
+    REQUIRE(replay.get(cv::CAP_PROP_FRAME_COUNT) == 2);
+
+    cv::Mat frame;
+    REQUIRE(replay.read(frame));
+    REQUIRE(replay.read(frame));
+    REQUIRE_FALSE(replay.read(frame));
+
+    REQUIRE_FALSE(ReplaySource(path + ".missing").isOpened());
+}
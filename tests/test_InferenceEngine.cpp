@@ -0,0 +1,176 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "FaceDetector.h"
+#include "Image.h"
+#include "InferenceBatcher.h"
+#include "InferenceEngine.h"
+#include "Model.h"
+
+static const std::string ENGINE_CASCADE_PATH = "model/haarcascade_frontalface_alt2.xml";
+static const std::string ENGINE_MODEL_PATH = "model/tensorflow_model.pb";
+
+TEST_CASE("Model::toPrediction picks the most probable class") {
+    float values[7] = {0.05f, 0.0f, 0.1f, 0.7f, 0.05f, 0.05f, 0.05f};
+    cv::Mat scores(1, 7, CV_32F, values);
+    EmotionPrediction prediction = Model::toPrediction(scores);
+
+    REQUIRE(prediction.class_id == 3);
+    REQUIRE(prediction.scores.size() == 7);
+    REQUIRE(std::fabs(prediction.probability - 0.7f) < 1e-6f);
+    REQUIRE(Model::formatPrediction(prediction).find("Happy") == 0);
+}
+
+TEST_CASE("Model maps class names to ids and back") {
+    REQUIRE(Model::classCount() == 7);
+    REQUIRE(Model::className(6) == "Neutral");
+    REQUIRE(Model::className(42).empty());
+    REQUIRE(Model::classId("surprise") == 5);
+    REQUIRE(Model::classId("Angry") == 0);
+    REQUIRE(Model::classId("contempt") == -1);
+}
+
+TEST_CASE("InferenceEngine matches Model from many threads") {
+    FaceDetector face_detector(ENGINE_CASCADE_PATH);
+    cv::Mat frame = cv::imread("src/image.jpg");
+    REQUIRE(!frame.empty());
+
+    face_detector.detectFace(frame);
+    Image image_and_ROI = face_detector.extractROI(frame);
+    REQUIRE(image_and_ROI.getROI().size() > 0);
+    image_and_ROI.preprocessROI();
+    std::vector<cv::Mat> inputs = image_and_ROI.getModelInput();
+
+    Model model(ENGINE_MODEL_PATH);
+    std::vector<std::string> expected = model.predict(image_and_ROI);
+
+    const size_t thread_count = 8;
+    const int iterations = 25;
+    InferenceEngine engine(ENGINE_MODEL_PATH);
+    REQUIRE_FALSE(engine.empty());
+
+    // Эталонный результат пачки, с ним сравниваются все потоки
+    std::vector<EmotionPrediction> reference = engine.predict(inputs);
+    REQUIRE(reference.size() == inputs.size());
+    REQUIRE(engine.predict(image_and_ROI) == expected);
+
+    // Время прохода сообщается отдельно от ожидания сети
+    double forward_ms = -1.0;
+    REQUIRE(engine.predict(inputs, forward_ms).size() == inputs.size());
+    REQUIRE(forward_ms > 0.0);
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < iterations; i++) {
+                std::vector<EmotionPrediction> predictions = engine.predict(inputs);
+                if (predictions.size() != reference.size()) {
+                    mismatches++;
+                    continue;
+                }
+                for (size_t j = 0; j < predictions.size(); j++) {
+                    bool same = predictions[j].class_id == reference[j].class_id &&
+                                predictions[j].scores.size() == reference[j].scores.size();
+                    for (size_t k = 0; same && k < predictions[j].scores.size(); k++) {
+                        same = std::fabs(predictions[j].scores[k] - reference[j].scores[k]) < 1e-5f;
+                    }
+                    if (!same) {
+                        mismatches++;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(engine.forwardCount() >= 1);
+    REQUIRE(engine.forwardCount() <= thread_count * iterations + 2);
+}
+
+TEST_CASE("InferenceEngine merges concurrent calls into shared forward passes") {
+    InferenceEngine engine(ENGINE_MODEL_PATH);
+    REQUIRE_FALSE(engine.empty());
+
+    // У каждого потока свои входы, чтобы проверить, что результаты объединённого прохода
+    // возвращаются своим вызовам
+    const int thread_count = 8;
+    const int iterations = 10;
+    std::vector<std::vector<cv::Mat>> inputs(thread_count);
+    std::vector<EmotionPrediction> reference(thread_count);
+    for (int t = 0; t < thread_count; t++) {
+        inputs[t].assign(64, cv::Mat(48, 48, CV_32F, cv::Scalar(0.1 * t)));
+        reference[t] = engine.predict(std::vector<cv::Mat>{inputs[t][0]}).at(0);
+    }
+    uint64_t single_forwards = engine.forwardCount();
+    REQUIRE(single_forwards == thread_count);
+
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < iterations; i++) {
+                std::vector<EmotionPrediction> predictions = engine.predict(inputs[t]);
+                if (predictions.size() != inputs[t].size()) {
+                    mismatches++;
+                    continue;
+                }
+                for (const EmotionPrediction& prediction : predictions) {
+                    if (prediction.class_id != reference[t].class_id ||
+                        std::fabs(prediction.probability - reference[t].probability) > 1e-5f) {
+                        mismatches++;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(mismatches == 0);
+    // Пока одна пачка выполняется, остальные накапливаются и выполняются вместе
+    REQUIRE(engine.forwardCount() - single_forwards < static_cast<uint64_t>(thread_count * iterations));
+}
+
+TEST_CASE("InferenceBatcher coalesces concurrent requests") {
+    InferenceEngine engine(ENGINE_MODEL_PATH);
+    REQUIRE_FALSE(engine.empty());
+
+    // Один и тот же вход, чтобы все результаты можно было сравнить с эталоном
+    cv::Mat input(48, 48, CV_32F, cv::Scalar(0.5));
+    EmotionPrediction reference = engine.predict(std::vector<cv::Mat>{input}).at(0);
+
+    InferenceBatcher::Settings settings;
+    settings.max_batch = 8;
+    settings.max_delay_ms = 20.0;
+    InferenceBatcher batcher(engine, settings);
+
+    const int request_count = 64;
+    std::vector<std::future<EmotionPrediction>> futures;
+    for (int i = 0; i < request_count; i++) {
+        futures.push_back(batcher.submit(input));
+    }
+
+    for (std::future<EmotionPrediction>& future : futures) {
+        EmotionPrediction prediction = future.get();
+        REQUIRE(prediction.class_id == reference.class_id);
+        REQUIRE(std::fabs(prediction.probability - reference.probability) < 1e-5f);
+    }
+
+    // Все запросы поставлены сразу, поэтому пачки должны быть больше одного входа
+    REQUIRE(batcher.batchCount() < static_cast<size_t>(request_count));
+    REQUIRE(batcher.meanBatchSize() > 1.0);
+    REQUIRE(batcher.queueStats().count() == static_cast<size_t>(request_count));
+}
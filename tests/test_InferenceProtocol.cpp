@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sys/socket.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "InferenceProtocol.h"
+#include "TestPaths.h"
+
+TEST_CASE("LocalSocket round-trips requests and responses over a socket pair") {
+    int fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    LocalSocket client(fds[0]);
+    LocalSocket server(fds[1]);
+
+    std::vector<unsigned char> sent(PROTOCOL_FACE_SIZE * PROTOCOL_FACE_SIZE * 2);
+    for (size_t i = 0; i < sent.size(); i++) {
+        sent[i] = static_cast<unsigned char>(i % 251);
+    }
+    RequestHeader request = {REQUEST_MAGIC, REQUEST_FACES, 42, static_cast<uint32_t>(sent.size())};
+    REQUIRE(client.writeRequest(request, sent.data()));
+
+    RequestHeader received;
+    std::vector<unsigned char> payload;
+    REQUIRE(server.readRequest(received, payload));
+    REQUIRE(received.kind == REQUEST_FACES);
+    REQUIRE(received.request_id == 42);
+    REQUIRE(payload == sent);
+
+    // Количество лиц в заголовке ответа задаётся по записям
+    std::vector<FaceResult> faces(2);
+    faces[0].class_id = 3;
+    faces[0].scores[3] = 0.75f;
+    faces[1].x = 10;
+    faces[1].class_id = 6;
+    REQUIRE(server.writeResponse({RESPONSE_MAGIC, RESPONSE_OK, received.request_id, 0}, faces));
+
+    ResponseHeader response;
+    std::vector<FaceResult> results;
+    REQUIRE(client.readResponse(response, results));
+    REQUIRE(response.status == RESPONSE_OK);
+    REQUIRE(response.request_id == 42);
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0].class_id == 3);
+    REQUIRE(results[0].scores[3] == 0.75f);
+    REQUIRE(results[1].x == 10);
+    REQUIRE(results[1].class_id == 6);
+
+    SECTION("Request with a wrong signature or oversized payload is rejected") {
+        RequestHeader wrong = {RESPONSE_MAGIC, REQUEST_FACES, 1, 0};
+        REQUIRE(client.writeAll(&wrong, sizeof(wrong)));
+        REQUIRE_FALSE(server.readRequest(received, payload));
+
+        RequestHeader oversized = {REQUEST_MAGIC, REQUEST_FACES, 2, PROTOCOL_MAX_PAYLOAD + 1};
+        REQUIRE(client.writeAll(&oversized, sizeof(oversized)));
+        REQUIRE_FALSE(server.readRequest(received, payload));
+    }
+
+    SECTION("Closed connection ends reading") {
+        client.close();
+        REQUIRE_FALSE(server.readRequest(received, payload));
+    }
+}
+
+TEST_CASE("LocalSocket::listen leaves a regular file at the socket path alone") {
+    TemporaryFile socket_file("emotion_socket", "file.sock");
+    {
+        std::ofstream file(socket_file.path);
+        file << "data";
+    }
+    REQUIRE_FALSE(LocalSocket::listen(socket_file.path).isOpen());
+
+    std::ifstream file(socket_file.path);
+    std::string content;
+    file >> content;
+    REQUIRE(content == "data");
+}
+
+TEST_CASE("LocalSocket::listen does not take over the socket of a running server") {
+    TemporaryFile socket_file("emotion_socket", "running.sock");
+    LocalSocket running = LocalSocket::listen(socket_file.path);
+    REQUIRE(running.isOpen());
+    REQUIRE_FALSE(LocalSocket::listen(socket_file.path).isOpen());
+    REQUIRE(LocalSocket::connect(socket_file.path).isOpen());
+}
+
+TEST_CASE("LocalSocket::listen replaces the socket left by a stopped server") {
+    TemporaryFile socket_file("emotion_socket", "stale.sock");
+    LocalSocket::listen(socket_file.path).close();
+    LocalSocket restarted = LocalSocket::listen(socket_file.path);
+    REQUIRE(restarted.isOpen());
+    REQUIRE(LocalSocket::connect(socket_file.path).isOpen());
+}
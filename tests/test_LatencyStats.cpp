@@ -0,0 +1,58 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "LatencyStats.h"
+
+TEST_CASE("LatencyStats computes nearest-rank percentiles") {
+    LatencyStats stats;
+    REQUIRE(stats.count() == 0);
+    REQUIRE(stats.percentile(50) == 0.0);
+
+    for (int i = 1; i <= 100; i++) {
+        stats.record(i);
+    }
+
+    REQUIRE(stats.count() == 100);
+    REQUIRE(stats.percentile(50) == 50.0);
+    REQUIRE(stats.percentile(99) == 99.0);
+    REQUIRE(stats.percentile(100) == 100.0);
+    REQUIRE(stats.percentile(0) == 1.0);
+    REQUIRE(stats.mean() == 50.5);
+    REQUIRE(stats.max() == 100.0);
+
+    stats.reset();
+    REQUIRE(stats.count() == 0);
+    REQUIRE(stats.max() == 0.0);
+}
+
+TEST_CASE("LatencyStats keeps only the latest samples for percentiles") {
+    LatencyStats stats(10);
+    for (int i = 1; i <= 20; i++) {
+        stats.record(i);
+    }
+
+    // Перцентили по последним 10 измерениям, счётчик и максимум по всем
+    REQUIRE(stats.percentile(0) == 11.0);
+    REQUIRE(stats.count() == 20);
+    REQUIRE(stats.max() == 20.0);
+}
+
+TEST_CASE("LatencyStats accepts samples from many threads") {
+    LatencyStats stats;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&stats]() {
+            for (int i = 0; i < 1000; i++) {
+                stats.record(1.0);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(stats.count() == 8000);
+    REQUIRE(stats.percentile(50) == 1.0);
+}
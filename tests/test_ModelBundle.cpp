@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <opencv2/opencv.hpp>
+
+#include "FaceDetector.h"
+#include "ModelBundle.h"
+#include "TestPaths.h"
+
+TEST_CASE("ModelBundle packs and maps model files") {
+    const std::string cascade_path = "model/haarcascade_frontalface_alt2.xml";
+    TemporaryFile bundle_file("emotion_models", "test.bundle");
+    std::filesystem::path bundle_path = bundle_file.path;
+
+    REQUIRE(ModelBundle::crc32("123456789", 9) == 0xCBF43926u);
+    REQUIRE(ModelBundle::write(bundle_path.string(), {{ModelBundle::CASCADE_ENTRY, cascade_path}}));
+
+    SECTION("Cascade from the bundle detects the same faces as from the file") {
+        ModelBundle bundle;
+        REQUIRE(bundle.open(bundle_path.string()));
+
+        const char* data = nullptr;
+        size_t size = 0;
+        REQUIRE(bundle.find(ModelBundle::CASCADE_ENTRY, data, size));
+        REQUIRE(size == std::filesystem::file_size(cascade_path));
+        REQUIRE_FALSE(bundle.find(ModelBundle::MODEL_ENTRY, data, size));
+
+        cv::Mat frame = cv::imread("src/image.jpg");
+        REQUIRE(!frame.empty());
+
+        FaceDetector from_file(cascade_path);
+        FaceDetector from_bundle(bundle);
+        std::vector<cv::Rect> expected = from_file.detectFace(frame);
+        std::vector<cv::Rect> actual = from_bundle.detectFace(frame);
+
+        REQUIRE(expected.size() > 0);
+        REQUIRE(actual == expected);
+    }
+
+    SECTION("Corrupted bundle is rejected") {
+        {
+            std::fstream file(bundle_path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(-1, std::ios::end);
+            file.put('X');
+        }
+
+        // Без проверки содержимого читаются только заголовок и таблица записей
+        ModelBundle unverified;
+        REQUIRE(unverified.open(bundle_path.string()));
+
+        ModelBundle bundle;
+        REQUIRE_FALSE(bundle.open(bundle_path.string(), true));
+        REQUIRE_FALSE(bundle.isOpen());
+        REQUIRE_FALSE(bundle.openForCli(bundle_path.string(), true, true));
+    }
+
+    SECTION("Only an explicitly given bundle is required on the command line") {
+        ModelBundle bundle;
+        REQUIRE(bundle.openForCli(bundle_path.string(), true));
+        REQUIRE(bundle.isOpen());
+
+        // Отсутствующий пакет по умолчанию пропускается, явно заданный - ошибка
+        TemporaryFile missing_file("emotion_models", "missing.bundle");
+        const std::string& missing = missing_file.path;
+        ModelBundle fallback;
+        REQUIRE(fallback.openForCli(missing, false));
+        REQUIRE_FALSE(fallback.isOpen());
+        REQUIRE(fallback.openForCli("", true));
+        REQUIRE_FALSE(fallback.openForCli(missing, true));
+    }
+}
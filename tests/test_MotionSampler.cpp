@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+#include "MotionSampler.h"
+
+/**
+ * @brief Однотонный кадр 128x72 заданной яркости.
+ */
+static cv::Mat flatFrame(int brightness) {
+    return cv::Mat(72, 128, CV_8UC3, cv::Scalar(brightness, brightness, brightness));
+}
+
+/**
+ * @brief Проходит видео длиной length секунд так же, как режим видео: шаг задаёт nextInterval.
+ * @param sampler Выборка кадров.
+ * @param length Длина видео, с.
+ * @param change_at Время смены сцены, с (отрицательное - сцена статична).
+ * @return Время обработанных кадров.
+ */
+static std::vector<double> sampleVideo(MotionSampler& sampler, double length, double change_at) {
+    std::vector<double> processed;
+    cv::Mat before = flatFrame(40);
+    cv::Mat after = flatFrame(200);
+    for (double time = 0; time < length; time = time + sampler.nextInterval()) {
+        const cv::Mat& frame = change_at >= 0 && time >= change_at ? after : before;
+        if (sampler.shouldProcess(frame, time)) {
+            processed.push_back(time);
+        }
+    }
+    return processed;
+}
+
+TEST_CASE("MotionSampler re-samples a static scene only at the maximum interval") {
+    MotionSampler sampler;
+    std::vector<double> processed = sampleVideo(sampler, 20.0, -1);
+
+    // Статичная сцена проверяется раз в секунду, но обрабатывается только раз в max_interval
+    std::vector<double> expected = {0.0, 5.0, 10.0, 15.0};
+    REQUIRE(processed == expected);
+    REQUIRE(sampler.nextInterval() == 1.0);
+}
+
+TEST_CASE("MotionSampler processes a scene change and samples densely afterwards") {
+    MotionSampler sampler;
+    std::vector<double> processed = sampleVideo(sampler, 14.0, 3.0);
+
+    // Смена сцены в 3 с обрабатывается сразу, затем кадры идут каждые 0,25 с до конца окна (6 с),
+    // после чего снова действует max_interval
+    std::vector<double> expected = {0.0};
+    for (double time = 3.0; time <= 6.0; time += 0.25) {
+        expected.push_back(time);
+    }
+    expected.push_back(11.0);
+    REQUIRE(processed == expected);
+    REQUIRE(sampler.lastScore() == 0.0);
+}
+
+TEST_CASE("MotionSampler scores the change against the last processed frame") {
+    MotionSampler sampler;
+    REQUIRE(sampler.shouldProcess(flatFrame(40), 0.0));
+    REQUIRE_FALSE(sampler.shouldProcess(flatFrame(41), 1.0));
+    REQUIRE(sampler.lastScore() < 0.03);
+
+    REQUIRE(sampler.shouldProcess(flatFrame(200), 2.0));
+    REQUIRE(sampler.lastScore() > 0.5);
+    REQUIRE(sampler.nextInterval() == 0.25);
+
+    sampler.reset();
+    REQUIRE(sampler.shouldProcess(flatFrame(200), 0.0));
+    REQUIRE_FALSE(sampler.shouldProcess(cv::Mat(), 1.0));
+}
+
+TEST_CASE("MotionSampler with --every-second settings processes exactly one frame per second") {
+    MotionSampler::Settings settings;
+    settings.threshold = -1;
+    settings.dense_window = 0;
+    MotionSampler sampler(settings);
+
+    std::vector<double> processed = sampleVideo(sampler, 10.0, 4.0);
+    std::vector<double> expected;
+    for (int second = 0; second < 10; second++) {
+        expected.push_back(second);
+    }
+    REQUIRE(processed == expected);
+}
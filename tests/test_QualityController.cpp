@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include "QualityController.h"
+
+/**
+ * @brief Быстрый регулятор из трёх уровней для тестов.
+ */
+static QualityController::Settings testSettings() {
+    QualityController::Settings settings;
+    settings.target_ms = 30.0;
+    settings.smoothing = 1.0;
+    settings.settle_frames = 2;
+    settings.recover_frames = 5;
+    settings.levels = QualityController::defaultLevels();
+    settings.levels.resize(3);
+    return settings;
+}
+
+TEST_CASE("QualityController steps down under load and recovers with headroom") {
+    QualityController controller(testSettings());
+    REQUIRE(controller.levelIndex() == 0);
+    REQUIRE(controller.levelCount() == 3);
+
+    // Кадры в пределах цели не меняют уровень
+    for (int i = 0; i < 20; i++) {
+        controller.plan();
+        REQUIRE_FALSE(controller.record(25.0));
+    }
+    REQUIRE(controller.levelIndex() == 0);
+
+    // Превышение цели сразу понижает качество, следующее решение - после settle_frames кадров
+    REQUIRE(controller.record(50.0));
+    REQUIRE(controller.levelIndex() == 1);
+    REQUIRE_FALSE(controller.record(50.0));
+    REQUIRE_FALSE(controller.record(50.0));
+    REQUIRE(controller.record(50.0));
+    REQUIRE(controller.levelIndex() == 2);
+
+    // Ниже самого дешёвого уровня опускаться некуда
+    for (int i = 0; i < 10; i++) {
+        REQUIRE_FALSE(controller.record(50.0));
+    }
+    REQUIRE(controller.levelIndex() == 2);
+
+    // Качество повышается только после recover_frames кадров с запасом подряд
+    int frames = 0;
+    while (!controller.record(10.0)) {
+        frames++;
+        REQUIRE(frames < 100);
+    }
+    REQUIRE(controller.levelIndex() == 1);
+    REQUIRE(frames >= 4);
+
+    REQUIRE(controller.framesAtLevel(0) == 20);
+}
+
+TEST_CASE("QualityController backs off after a failed recovery") {
+    QualityController controller(testSettings());
+    controller.record(50.0);
+    REQUIRE(controller.levelIndex() == 1);
+
+    auto framesToRecover = [&]() {
+        int frames = 0;
+        while (!controller.record(10.0)) {
+            frames++;
+        }
+        return frames;
+    };
+
+    int first = framesToRecover();
+    REQUIRE(controller.levelIndex() == 0);
+
+    // Сразу после повышения уровень снова перегружен
+    controller.record(10.0);
+    controller.record(10.0);
+    REQUIRE(controller.record(50.0));
+    REQUIRE(controller.levelIndex() == 1);
+
+    int second = framesToRecover();
+    REQUIRE(second > first);
+}
+
+TEST_CASE("QualityController plans detection and inference cadence per level") {
+    QualityController::Settings settings = testSettings();
+    settings.levels.resize(2);
+    settings.levels[1].detect_interval = 2;
+    settings.levels[1].infer_interval = 3;
+    QualityController controller(settings);
+
+    // На полном качестве каждый кадр проходит детекцию и предсказание
+    for (int i = 0; i < 4; i++) {
+        QualityController::Plan plan = controller.plan();
+        REQUIRE(plan.detect);
+        REQUIRE(plan.infer);
+    }
+
+    controller.record(50.0);
+    REQUIRE(controller.levelIndex() == 1);
+
+    std::vector<bool> detect;
+    std::vector<bool> infer;
+    for (int i = 0; i < 12; i++) {
+        QualityController::Plan plan = controller.plan();
+        detect.push_back(plan.detect);
+        infer.push_back(plan.infer);
+    }
+    std::vector<bool> expected_detect = {true, false, true, false, true, false, true, false, true, false, true, false};
+    std::vector<bool> expected_infer = {true, false, false, false, false, false, true, false, false, false, false, false};
+    REQUIRE(detect == expected_detect);
+    REQUIRE(infer == expected_infer);
+
+    REQUIRE_FALSE(QualityController::describe(controller.level()).empty());
+    REQUIRE(controller.summary().find("level 1/1") == 0);
+}
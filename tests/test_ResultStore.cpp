@@ -0,0 +1,173 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+#include <string>
+
+#include "ResultStore.h"
+#include "TestPaths.h"
+
+/**
+ * @brief Количество классов в тестовых хранилищах.
+ */
+static const size_t TEST_CLASSES = 7;
+
+/**
+ * @brief Предсказание для записи с номером index: класс index % 7, его вероятность растёт с номером.
+ */
+static EmotionPrediction testPrediction(uint64_t index) {
+    EmotionPrediction prediction;
+    prediction.class_id = static_cast<int>(index % TEST_CLASSES);
+    prediction.scores.assign(TEST_CLASSES, 0.01f);
+    prediction.scores[prediction.class_id] = static_cast<float>(index % 100) / 100.0f;
+    prediction.probability = prediction.scores[prediction.class_id];
+    return prediction;
+}
+
+/**
+ * @brief Дописывает записи [first, last) со временем index * 0.1 с.
+ */
+static void appendRecords(ResultStoreWriter& writer, uint64_t first, uint64_t last) {
+    for (uint64_t i = first; i < last; i++) {
+        REQUIRE(writer.append(i * 0.1, static_cast<uint32_t>(i), cv::Rect(static_cast<int>(i % 500), 20, 64, 64),
+                              testPrediction(i)));
+    }
+}
+
+TEST_CASE("ResultStore reads back records across blocks") {
+    TemporaryFile store_file("emotion_results", "roundtrip.emres");
+    const std::string& path = store_file.path;
+    const uint64_t count = 2 * RESULT_STORE_BLOCK_CAPACITY + 100;
+    {
+        ResultStoreWriter writer;
+        REQUIRE(writer.open(path, TEST_CLASSES));
+        appendRecords(writer, 0, count);
+        REQUIRE(writer.close());
+    }
+
+    ResultStore store;
+    REQUIRE(store.open(path));
+    REQUIRE(store.size() == count);
+    REQUIRE(store.classCount() == TEST_CLASSES);
+    for (uint64_t i : {uint64_t(0), uint64_t(RESULT_STORE_BLOCK_CAPACITY - 1), uint64_t(RESULT_STORE_BLOCK_CAPACITY),
+                       count - 1}) {
+        REQUIRE(store.timestamp(i) == i * 0.1);
+        REQUIRE(store.frameNumber(i) == i);
+        REQUIRE(store.face(i) == cv::Rect(static_cast<int>(i % 500), 20, 64, 64));
+        REQUIRE(store.classId(i) == static_cast<int>(i % TEST_CLASSES));
+        REQUIRE(store.score(i, static_cast<int>(i % TEST_CLASSES)) == testPrediction(i).probability);
+    }
+}
+
+TEST_CASE("ResultStore answers time range queries") {
+    TemporaryFile store_file("emotion_results", "range.emres");
+    const std::string& path = store_file.path;
+    const uint64_t count = RESULT_STORE_BLOCK_CAPACITY + 1000;
+    {
+        ResultStoreWriter writer;
+        REQUIRE(writer.open(path, TEST_CLASSES));
+        appendRecords(writer, 0, count);
+    }
+
+    ResultStore store;
+    REQUIRE(store.open(path));
+
+    SECTION("lowerBound finds the first record at or after a time") {
+        REQUIRE(store.lowerBound(-1.0) == 0);
+        REQUIRE(store.lowerBound(0.0) == 0);
+        REQUIRE(store.lowerBound(0.05) == 1);
+        REQUIRE(store.lowerBound(RESULT_STORE_BLOCK_CAPACITY * 0.1 - 0.05) == RESULT_STORE_BLOCK_CAPACITY);
+        REQUIRE(store.lowerBound(RESULT_STORE_BLOCK_CAPACITY * 0.1 + 0.05) == RESULT_STORE_BLOCK_CAPACITY + 1);
+        REQUIRE(store.lowerBound(1e9) == count);
+    }
+
+    SECTION("distribution counts each class in a half-open interval") {
+        // Записи 400..469: 70 записей, по 10 каждого класса
+        std::vector<uint64_t> counts = store.distribution(39.95, 46.95);
+        REQUIRE(counts.size() == TEST_CLASSES);
+        for (uint64_t value : counts) {
+            REQUIRE(value == 10);
+        }
+
+        uint64_t total = 0;
+        for (uint64_t value : store.distribution(-1.0, 1e9)) {
+            total += value;
+        }
+        REQUIRE(total == count);
+    }
+
+    SECTION("findAbove returns records over the threshold in time order") {
+        std::vector<uint64_t> matches = store.findAbove(0, 0.9f, 0.0, 100.0);
+        REQUIRE_FALSE(matches.empty());
+        for (size_t i = 0; i < matches.size(); i++) {
+            REQUIRE(matches[i] % TEST_CLASSES == 0);
+            REQUIRE(matches[i] % 100 > 90);
+            REQUIRE(store.timestamp(matches[i]) < 100.0);
+            if (i > 0) {
+                REQUIRE(matches[i] > matches[i - 1]);
+            }
+        }
+        REQUIRE(store.findAbove(static_cast<int>(TEST_CLASSES), 0.0f).empty());
+    }
+}
+
+TEST_CASE("ResultStoreWriter resumes from a checkpoint") {
+    TemporaryFile store_file("emotion_results", "resume.emres");
+    const std::string& path = store_file.path;
+    {
+        ResultStoreWriter writer;
+        REQUIRE(writer.open(path, TEST_CLASSES));
+        appendRecords(writer, 0, RESULT_STORE_BLOCK_CAPACITY + 500);
+        REQUIRE(writer.flush());
+    }
+
+    // Возобновление внутри первого и второго блока: записи после точки отбрасываются и пишутся заново
+    for (uint64_t resume_at : {uint64_t(1000), uint64_t(RESULT_STORE_BLOCK_CAPACITY + 200)}) {
+        {
+            ResultStoreWriter writer;
+            REQUIRE(writer.open(path, TEST_CLASSES, resume_at * 0.1 - 0.05));
+            REQUIRE(writer.size() == resume_at);
+            REQUIRE_FALSE(writer.append(0.0, 0, cv::Rect(), testPrediction(0)));
+            appendRecords(writer, resume_at, RESULT_STORE_BLOCK_CAPACITY + 500);
+        }
+
+        ResultStore store;
+        REQUIRE(store.open(path));
+        REQUIRE(store.size() == RESULT_STORE_BLOCK_CAPACITY + 500);
+        for (uint64_t i = 0; i < store.size(); i++) {
+            REQUIRE(store.timestamp(i) == i * 0.1);
+        }
+    }
+
+    // Записи без flush не видны читателям
+    {
+        ResultStoreWriter writer;
+        REQUIRE(writer.open(path, TEST_CLASSES, 0.0));
+        appendRecords(writer, 0, 10);
+
+        ResultStore store;
+        REQUIRE(store.open(path));
+        REQUIRE(store.size() == 0);
+
+        REQUIRE(writer.flush());
+        REQUIRE(store.open(path));
+        REQUIRE(store.size() == 10);
+    }
+
+    // Хранилище с другим количеством классов не открывается
+    ResultStoreWriter writer;
+    REQUIRE_FALSE(writer.open(path, TEST_CLASSES + 1));
+}
+
+TEST_CASE("ResultStore rejects files in another format") {
+    TemporaryFile store_file("emotion_results", "invalid.emres");
+    const std::string& path = store_file.path;
+    {
+        std::ofstream output(path, std::ios::binary);
+        output << std::string(128, 'x');
+    }
+
+    ResultStore store;
+    REQUIRE_FALSE(store.open(path));
+    REQUIRE_FALSE(store.isOpen());
+    REQUIRE_FALSE(store.open(path + ".missing"));
+}
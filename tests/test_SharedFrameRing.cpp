@@ -0,0 +1,163 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <thread>
+
+#include "SharedFrameRing.h"
+#include "TestPaths.h"
+
+/**
+ * @brief Кадр 8x4, все пиксели которого равны value.
+ */
+static cv::Mat testFrame(int value) {
+    return cv::Mat(4, 8, CV_8UC1, cv::Scalar(value));
+}
+
+TEST_CASE("SharedFrameRing delivers frames in order without copying") {
+    std::string name = testRingName("order");
+    SharedFrameRing producer;
+    REQUIRE(producer.create(name, 4, cv::Size(8, 4), CV_8UC1));
+
+    SharedFrameRing consumer;
+    REQUIRE(consumer.open(name));
+    REQUIRE(consumer.frameSize() == cv::Size(8, 4));
+    REQUIRE(consumer.frameType() == CV_8UC1);
+    REQUIRE(consumer.slotCount() == 4);
+
+    SharedFrameRing::View view;
+    REQUIRE_FALSE(consumer.acquire(view));
+
+    // Кадр другого размера не публикуется
+    REQUIRE_FALSE(producer.write(cv::Mat(2, 2, CV_8UC1, cv::Scalar(0)), 0.0));
+
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(producer.write(testFrame(10 + i), i * 0.5));
+    }
+
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(consumer.acquire(view));
+        REQUIRE(view.frame_number == static_cast<uint64_t>(i));
+        REQUIRE(view.timestamp == i * 0.5);
+        REQUIRE(view.mat.at<uchar>(3, 7) == 10 + i);
+        REQUIRE(consumer.isValid(view));
+    }
+    REQUIRE_FALSE(consumer.acquire(view));
+    REQUIRE(consumer.dropped() == 0);
+}
+
+TEST_CASE("SharedFrameRing detects overwritten slots and lagging consumers") {
+    std::string name = testRingName("lag");
+    SharedFrameRing producer;
+    REQUIRE(producer.create(name, 4, cv::Size(8, 4), CV_8UC1));
+    SharedFrameRing consumer;
+    REQUIRE(consumer.open(name));
+
+    SECTION("A view becomes invalid once its slot is reused") {
+        REQUIRE(producer.write(testFrame(1), 0.0));
+        SharedFrameRing::View view;
+        REQUIRE(consumer.acquire(view));
+
+        for (int i = 0; i < 3; i++) {
+            REQUIRE(producer.write(testFrame(2), 0.0));
+        }
+        REQUIRE(consumer.isValid(view));
+
+        REQUIRE(producer.write(testFrame(3), 0.0));
+        REQUIRE_FALSE(consumer.isValid(view));
+
+        // Заголовок указывает прямо на слот, поэтому видит новый кадр
+        REQUIRE(view.mat.at<uchar>(0, 0) == 3);
+    }
+
+    SECTION("A lagging consumer skips to the oldest safe frame") {
+        for (int i = 0; i < 10; i++) {
+            REQUIRE(producer.write(testFrame(i), i));
+        }
+
+        SharedFrameRing::View view;
+        REQUIRE(consumer.acquire(view));
+        REQUIRE(view.frame_number == 7);
+        REQUIRE(consumer.dropped() == 7);
+        REQUIRE(view.mat.at<uchar>(0, 0) == 7);
+    }
+
+    SECTION("Latest mode returns only the newest frame") {
+        for (int i = 0; i < 3; i++) {
+            REQUIRE(producer.write(testFrame(i), i));
+        }
+
+        SharedFrameRing::View view;
+        REQUIRE(consumer.acquire(view, true));
+        REQUIRE(view.frame_number == 2);
+        REQUIRE_FALSE(consumer.acquire(view, true));
+    }
+
+    SECTION("Closing the producer is visible to consumers") {
+        REQUIRE_FALSE(consumer.producerClosed());
+        producer.close();
+        REQUIRE(consumer.producerClosed());
+
+        // Новые потребители больше не могут подключиться
+        SharedFrameRing late;
+        REQUIRE_FALSE(late.open(name));
+    }
+}
+
+TEST_CASE("SharedFrameRing never hands out torn frames to a concurrent consumer") {
+    std::string name = testRingName("threads");
+    SharedFrameRing producer;
+    REQUIRE(producer.create(name, 8, cv::Size(64, 48), CV_8UC1));
+    SharedFrameRing consumer;
+    REQUIRE(consumer.open(name));
+
+    const int frame_count = 2000;
+    std::thread writer([&]() {
+        for (int i = 0; i < frame_count; i++) {
+            producer.write(cv::Mat(48, 64, CV_8UC1, cv::Scalar(i % 256)), i);
+        }
+    });
+
+    // Каждый скопированный кадр должен целиком состоять из одного значения, равного его номеру,
+    // а номера кадров должны возрастать
+    int received = 0;
+    int broken = 0;
+    double last_timestamp = -1.0;
+    while (last_timestamp < frame_count - 1) {
+        cv::Mat frame;
+        double timestamp = 0.0;
+        if (!consumer.read(frame, timestamp)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        double min_value = 0.0;
+        double max_value = 0.0;
+        cv::minMaxLoc(frame, &min_value, &max_value);
+        if (min_value != max_value || static_cast<int>(min_value) != static_cast<int>(timestamp) % 256 ||
+            timestamp <= last_timestamp) {
+            broken++;
+        }
+        last_timestamp = timestamp;
+        received++;
+    }
+    writer.join();
+
+    REQUIRE(broken == 0);
+    REQUIRE(received > 0);
+    REQUIRE(received + static_cast<int>(consumer.dropped()) <= frame_count);
+}
+
+TEST_CASE("SharedFrameRing requires at least two slots") {
+    std::string name = testRingName("single");
+    SharedFrameRing producer;
+    REQUIRE_FALSE(producer.create(name, 1, cv::Size(8, 4), CV_8UC1));
+    REQUIRE(producer.create(name, 2, cv::Size(8, 4), CV_8UC1));
+
+    SharedFrameRing consumer;
+    REQUIRE(consumer.open(name));
+    REQUIRE(producer.write(testFrame(7), 1.0));
+    SharedFrameRing::View view;
+    REQUIRE(consumer.acquire(view, false));
+    REQUIRE(view.mat.at<uchar>(0, 0) == 7);
+}
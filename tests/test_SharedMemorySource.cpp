@@ -0,0 +1,62 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "SharedFrameRing.h"
+#include "SharedMemorySource.h"
+#include "TestPaths.h"
+
+TEST_CASE("SharedMemorySource rejects frames the producer overwrote during processing") {
+    std::string name = testRingName("source");
+    const cv::Size size(320, 240);
+    SharedFrameRing producer;
+    REQUIRE(producer.create(name, 2, size, CV_8UC1));
+
+    // Производитель непрерывно перезаписывает кольцо из двух слотов кадрами, все пиксели
+    // которых равны номеру кадра по модулю 251; номер передаётся и во времени кадра
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (int number = 0; !done.load(); number++) {
+            producer.write(cv::Mat(size, CV_8UC1, cv::Scalar(number % 251)), number);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    SharedMemorySource source(name, std::chrono::milliseconds(1000));
+    REQUIRE(source.isOpened());
+
+    // Тот же путь, что в режиме камеры: обработка прямо в слоте, копирование в буфер пула
+    // и проверка после копирования. Каждый второй кадр обрабатывается дольше, чем производитель
+    // успевает дважды обойти кольцо
+    cv::Mat slot;
+    cv::Mat copy;
+    int accepted = 0;
+    int rejected = 0;
+    bool intact = true;
+    for (int i = 0; i < 200; i++) {
+        REQUIRE(source.read(slot));
+        if (i % 2 == 1) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        slot.copyTo(copy);
+        if (!source.lastFrameValid()) {
+            rejected++;
+            continue;
+        }
+
+        // Принятая копия целиком принадлежит кадру, время которого вернул источник
+        int expected = static_cast<int>(source.timestamp()) % 251;
+        intact = intact && cv::countNonZero(copy != expected) == 0;
+        accepted++;
+    }
+    done = true;
+    writer.join();
+
+    REQUIRE(intact);
+    REQUIRE(accepted > 0);
+    REQUIRE(rejected > 0);
+}
@@ -0,0 +1,59 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "TripleBuffer.h"
+
+TEST_CASE("TripleBuffer returns the latest value once") {
+    TripleBuffer<int> buffer;
+    int value = 0;
+    REQUIRE_FALSE(buffer.read(value));
+
+    buffer.write(1);
+    buffer.write(2);
+    REQUIRE(buffer.read(value));
+    REQUIRE(value == 2);
+    REQUIRE_FALSE(buffer.read(value));
+
+    buffer.write(3);
+    REQUIRE(buffer.read(value));
+    REQUIRE(value == 3);
+}
+
+TEST_CASE("TripleBuffer never hands out an older or repeated value across threads") {
+    TripleBuffer<uint64_t> buffer;
+    const uint64_t count = 200000;
+    std::atomic<bool> done{false};
+
+    // Производитель публикует возрастающие номера без ожидания потребителя
+    std::thread producer([&]() {
+        for (uint64_t sequence = 1; sequence <= count; sequence++) {
+            buffer.write(sequence);
+        }
+        done = true;
+    });
+
+    uint64_t last = 0;
+    uint64_t received = 0;
+    bool ordered = true;
+    for (;;) {
+        // Признак завершения читается до попытки чтения, чтобы не потерять последнее значение
+        bool finished = done.load();
+        uint64_t value = 0;
+        if (buffer.read(value)) {
+            ordered = ordered && value > last;
+            last = value;
+            received++;
+        } else if (finished) {
+            break;
+        }
+    }
+    producer.join();
+
+    REQUIRE(ordered);
+    REQUIRE(last == count);
+    REQUIRE(received >= 1);
+    REQUIRE(received <= count);
+}
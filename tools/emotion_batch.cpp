@@ -0,0 +1,326 @@
+/**
+ * @file emotion_batch.cpp
+ * @brief Пакетная обработка списка видеофайлов с возобновлением по контрольным точкам.
+ * Состояние задания хранится в манифесте (BatchJob): обработанные файлы пропускаются,
+ * прерванный файл продолжается с последней контрольной точки, а файлы с ошибкой
+ * повторяются ограниченное число раз. С --results-dir предсказания по каждому лицу
+ * дописываются в хранилище результатов файла (ResultStore) и переживают возобновление.
+ */
+
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BatchJob.h"
+#include "FaceDetector.h"
+#include "FramePool.h"
+#include "FrameClassifier.h"
+#include "Image.h"
+#include "InferenceEngine.h"
+#include "Model.h"
+#include "ModelBundle.h"
+#include "MotionSampler.h"
+#include "ResultStore.h"
+#include "Video.h"
+
+/**
+ * @brief Признак остановки задания (SIGINT, SIGTERM).
+ */
+static std::atomic<bool> stop_requested{false};
+
+/**
+ * @brief Обработчик сигналов остановки.
+ */
+static void requestStop(int) {
+    stop_requested = true;
+}
+
+/**
+ * @struct BatchOptions
+ * @brief Параметры командной строки.
+ */
+struct BatchOptions {
+    std::string manifest_path; ///< Путь к манифесту задания.
+    std::vector<std::string> videos; ///< Видеофайлы, добавляемые в задание.
+    std::string bundle_path = ModelBundle::DEFAULT_PATH; ///< Путь к пакету моделей.
+    bool bundle_required = false; ///< Пакет моделей задан явно (--bundle): без него запуск прерывается.
+    bool bundle_verify = false; ///< Проверять контрольные суммы содержимого пакета (--verify-bundle).
+    double checkpoint_interval = 30.0; ///< Интервал между контрольными точками, с.
+    int max_attempts = 3; ///< Наибольшее количество попыток для файла с ошибкой.
+    bool every_second = false; ///< Обрабатывать каждую секунду видео без адаптивной выборки.
+    bool quality_gate = true; ///< Не передавать в модель непригодные лица.
+    std::string results_dir; ///< Каталог хранилищ результатов (пусто - не сохранять).
+};
+
+/**
+ * @brief Читает список видеофайлов, по одному пути в строке.
+ * @param filename Путь к списку.
+ * @param videos Список, в который добавляются пути.
+ * @return true, если список прочитан.
+ */
+static bool readList(const std::string& filename, std::vector<std::string>& videos) {
+    std::ifstream input(filename);
+    if (!input.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line[0] != '#') {
+            videos.push_back(line);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Путь к хранилищу результатов файла задания.
+ * Номер файла в манифесте исключает совпадение имён из разных каталогов.
+ * @param options Параметры командной строки.
+ * @param index Индекс файла в манифесте.
+ * @param path Путь к видеофайлу.
+ * @return Путь к хранилищу.
+ */
+static std::string resultsPath(const BatchOptions& options, size_t index, const std::string& path) {
+    std::string name = std::to_string(index) + "_" + std::filesystem::path(path).stem().string() + ".emres";
+    return (std::filesystem::path(options.results_dir) / name).string();
+}
+
+/**
+ * @brief Обрабатывает один видеофайл с позиции из манифеста, периодически сохраняя контрольные точки.
+ * Статистика строится так же, как в режиме видео emotion_detector: одна запись на секунду видео,
+ * на пропущенные кадры переносится последнее предсказание.
+ * @param job Манифест задания.
+ * @param index Индекс файла в манифесте.
+ * @param classifier Детектор, оценка качества и модель, общие для всех файлов задания.
+ * @param options Параметры командной строки.
+ * @return true, если файл обработан до конца; false при ошибке или остановке.
+ */
+static bool processVideo(BatchJob& job, size_t index, FrameClassifier& classifier, const BatchOptions& options) {
+    BatchJob::Entry& entry = job.entries()[index];
+    cv::VideoCapture capture(entry.path);
+    if (!capture.isOpened()) {
+        std::cerr << "Unable to open " << entry.path << std::endl;
+        entry.status = BatchJob::FAILED;
+        return false;
+    }
+
+    Video video(capture);
+    double length = video.getLengthInSeconds();
+    if (!(length > 0)) {
+        std::cerr << "Unable to determine the length of " << entry.path << std::endl;
+        entry.status = BatchJob::FAILED;
+        return false;
+    }
+
+    MotionSampler::Settings sampler_settings;
+    if (options.every_second) {
+        sampler_settings.threshold = -1;
+        sampler_settings.dense_window = 0;
+    }
+    // Опорный кадр выборки не сохраняется: после возобновления первый кадр всегда обрабатывается
+    MotionSampler sampler(sampler_settings);
+
+    // Записи после контрольной точки отбрасываются: эти кадры будут обработаны заново
+    ResultStoreWriter results;
+    if (!options.results_dir.empty() &&
+        !results.open(resultsPath(options, index, entry.path), Model::classCount(), entry.position)) {
+        entry.status = BatchJob::FAILED;
+        return false;
+    }
+
+    FramePool frame_pool(1);
+    FramePool::Frame pooled_frame = frame_pool.acquire();
+    auto last_checkpoint = std::chrono::steady_clock::now();
+
+    if (entry.position > 0) {
+        std::cout << "Resuming " << entry.path << " at " << entry.position << " s of " << length << " s" << std::endl;
+    }
+
+    while (entry.position < length) {
+        if (stop_requested) {
+            return false;
+        }
+
+        cv::Mat& frame = pooled_frame.mat();
+        double time = entry.position;
+        if (video.read(time, frame) && sampler.shouldProcess(frame, time)) {
+            entry.last_class = classifier.classify(frame);
+            uint32_t frame_number = static_cast<uint32_t>(std::max(0.0, capture.get(cv::CAP_PROP_POS_FRAMES) - 1));
+            for (size_t i = 0; i < classifier.predictions().size() && i < classifier.faces().size(); i++) {
+                results.append(time, frame_number, classifier.faces()[i], classifier.predictions()[i]);
+            }
+        }
+
+        size_t seconds = FrameClassifier::recordSeconds(time, entry.next_record);
+        if (entry.last_class >= 0) {
+            entry.class_seconds[entry.last_class] += seconds;
+        }
+        entry.position = time + sampler.nextInterval();
+
+        // Контрольная точка: позиция и частичная статистика сохраняются вместе; результаты
+        // записываются раньше манифеста, чтобы позиция никогда не опережала хранилище
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - last_checkpoint).count() >= options.checkpoint_interval) {
+            if (!options.results_dir.empty() && !results.flush()) {
+                std::cerr << "Unable to write results for " << entry.path << std::endl;
+            } else if (!job.save()) {
+                std::cerr << "Unable to write checkpoint " << job.path() << std::endl;
+            }
+            last_checkpoint = now;
+        }
+    }
+
+    if (!options.results_dir.empty() && !results.flush()) {
+        std::cerr << "Unable to write results for " << entry.path << std::endl;
+        entry.status = BatchJob::FAILED;
+        return false;
+    }
+    entry.status = BatchJob::DONE;
+    return true;
+}
+
+/**
+ * @brief Выводит сводку по заданию: состояние файлов и суммарные секунды по классам обработанных файлов.
+ * @param job Манифест задания.
+ */
+static void printSummary(BatchJob& job) {
+    std::vector<uint64_t> totals(Model::classCount(), 0);
+    std::vector<size_t> statuses(BatchJob::FAILED + 1, 0);
+    for (const BatchJob::Entry& entry : job.entries()) {
+        statuses[entry.status]++;
+        if (entry.status == BatchJob::DONE) {
+            for (size_t i = 0; i < totals.size(); i++) {
+                totals[i] += entry.class_seconds[i];
+            }
+        }
+    }
+
+    for (int status = BatchJob::PENDING; status <= BatchJob::FAILED; status++) {
+        std::cout << std::setw(10) << BatchJob::statusName(static_cast<BatchJob::Status>(status)) << " : "
+                  << statuses[status] << " files" << std::endl;
+    }
+    std::cout << "Seconds per emotion in completed files" << std::endl;
+    for (size_t i = 0; i < totals.size(); i++) {
+        std::cout << std::setw(10) << Model::className(static_cast<int>(i)) << " : " << totals[i] << std::endl;
+    }
+}
+
+/**
+ * @brief Главная функция пакетной обработки.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы: путь к манифесту, видеофайлы, --list FILE, --checkpoint-interval S,
+ * --max-attempts N, --bundle PATH, --verify-bundle, --every-second, --no-quality-gate, --results-dir DIR.
+ * @return 0, если все файлы обработаны; 1 при ошибке; 2, если задание остановлено или есть файлы с ошибкой.
+ */
+int main(int argc, char** argv) {
+    BatchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--list" && i + 1 < argc) {
+            if (!readList(argv[++i], options.videos)) {
+                std::cerr << "Unable to read list " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--checkpoint-interval" && i + 1 < argc) {
+            options.checkpoint_interval = std::stod(argv[++i]);
+        } else if (arg == "--max-attempts" && i + 1 < argc) {
+            options.max_attempts = std::stoi(argv[++i]);
+        } else if (arg == "--bundle" && i + 1 < argc) {
+            options.bundle_path = argv[++i];
+            options.bundle_required = true;
+        } else if (arg == "--verify-bundle") {
+            options.bundle_verify = true;
+        } else if (arg == "--every-second") {
+            options.every_second = true;
+        } else if (arg == "--no-quality-gate") {
+            options.quality_gate = false;
+        } else if (arg == "--results-dir" && i + 1 < argc) {
+            options.results_dir = argv[++i];
+        } else if (options.manifest_path.empty()) {
+            options.manifest_path = arg;
+        } else {
+            options.videos.push_back(arg);
+        }
+    }
+    if (options.manifest_path.empty()) {
+        std::cerr << "usage: " << argv[0] << " <manifest> [video ...] [--list FILE] [--checkpoint-interval S]"
+                  << " [--max-attempts N] [--bundle PATH] [--verify-bundle] [--every-second] [--no-quality-gate] [--results-dir DIR]"
+                  << std::endl;
+        return 1;
+    }
+
+    BatchJob job(options.manifest_path, Model::classCount());
+    if (!job.load()) {
+        std::cerr << "Manifest " << options.manifest_path << " is corrupted" << std::endl;
+        return 1;
+    }
+    size_t added = job.addFiles(options.videos);
+    if (!job.save()) {
+        std::cerr << "Unable to write manifest " << options.manifest_path << std::endl;
+        return 1;
+    }
+    if (!options.results_dir.empty()) {
+        std::filesystem::create_directories(options.results_dir);
+    }
+    std::cout << job.entries().size() << " files in the job, " << added << " new or changed" << std::endl;
+
+    ModelBundle bundle;
+    if (!bundle.openForCli(options.bundle_path, options.bundle_required, options.bundle_verify)) {
+        return 1;
+    }
+    std::unique_ptr<FaceDetector> face_detector(bundle.isOpen() ? new FaceDetector(bundle)
+                                                                : new FaceDetector(ModelBundle::DEFAULT_CASCADE_PATH));
+    std::unique_ptr<InferenceEngine> engine(bundle.isOpen() ? new InferenceEngine(bundle)
+                                                            : new InferenceEngine(ModelBundle::DEFAULT_MODEL_PATH));
+    if (engine->empty()) {
+        return 1;
+    }
+    FrameClassifier classifier(*face_detector, [&engine](Image& image) { return engine->predict(image.getModelInput()); },
+                               options.quality_gate);
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    for (size_t i = 0; i < job.entries().size() && !stop_requested; i++) {
+        BatchJob::Entry& entry = job.entries()[i];
+        if (!BatchJob::needsWork(entry, options.max_attempts)) {
+            continue;
+        }
+
+        // Попытка фиксируется до начала обработки, чтобы файл, на котором процесс падает,
+        // не повторялся бесконечно
+        entry.status = BatchJob::RUNNING;
+        entry.attempts++;
+        job.save();
+
+        std::cout << "Processing " << entry.path << " (attempt " << entry.attempts << ")" << std::endl;
+        if (processVideo(job, i, classifier, options)) {
+            std::cout << "Done " << entry.path << std::endl;
+        } else if (stop_requested && entry.status == BatchJob::RUNNING) {
+            // Остановка по сигналу не считается неудачной попыткой
+            entry.attempts--;
+        }
+        job.save();
+    }
+
+    if (stop_requested) {
+        std::cout << "Stopped; the job resumes from the last checkpoint on the next run" << std::endl;
+    }
+    printSummary(job);
+
+    for (const BatchJob::Entry& entry : job.entries()) {
+        if (entry.status != BatchJob::DONE) {
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file emotion_bundle.cpp
+ * @brief Утилита упаковки каскада лиц и модели TensorFlow в пакет моделей.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "ModelBundle.h"
+
+/**
+ * @brief Главная функция утилиты.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы: путь к пакету, путь к каскаду (.xml), путь к модели (.pb).
+ * @return Код завершения программы.
+ */
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        std::cerr << "usage: " << argv[0] << " <output.bundle> <cascade.xml> <model.pb>" << std::endl;
+        return 1;
+    }
+
+    std::string output = argv[1];
+    bool written = ModelBundle::write(output, {{ModelBundle::CASCADE_ENTRY, argv[2]},
+                                               {ModelBundle::MODEL_ENTRY, argv[3]}});
+    if (!written) {
+        return 1;
+    }
+
+    // Проверка записанного пакета вместе с контрольными суммами содержимого
+    ModelBundle bundle;
+    if (!bundle.open(output, true)) {
+        return 1;
+    }
+
+    std::cout << "Model bundle saved to " << output << std::endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file emotion_capture.cpp
+ * @brief Процесс захвата: публикует кадры камеры, видеофайла или записи в кольцо в разделяемой памяти.
+ * Распознавание запускается отдельно: emotion_detector --shm NAME.
+ */
+
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "CaptureSource.h"
+#include "ReplaySource.h"
+#include "SharedFrameRing.h"
+
+/**
+ * @brief Признак остановки захвата (SIGINT, SIGTERM).
+ */
+static std::atomic<bool> stop_requested{false};
+
+/**
+ * @brief Обработчик сигналов остановки.
+ */
+static void requestStop(int) {
+    stop_requested = true;
+}
+
+/**
+ * @brief Главная функция процесса захвата.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы: имя кольца, --slots N (не меньше 2), --device N, --file PATH или --replay PATH [--max-speed].
+ * @return Код завершения программы.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <ring-name> [--slots N (>= 2)] [--device N | --file PATH | --replay PATH [--max-speed]]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::string name = argv[1];
+    size_t slots = 8;
+    int device = 0;
+    std::string filename;
+    std::string replay_path;
+    bool max_speed = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--slots" && i + 1 < argc) {
+            slots = std::stoul(argv[++i]);
+            if (slots < SharedFrameRing::MIN_SLOT_COUNT) {
+                std::cerr << "--slots must be at least " << SharedFrameRing::MIN_SLOT_COUNT << std::endl;
+                return 1;
+            }
+        } else if (arg == "--device" && i + 1 < argc) {
+            device = std::stoi(argv[++i]);
+        } else if (arg == "--file" && i + 1 < argc) {
+            filename = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (arg == "--max-speed") {
+            max_speed = true;
+        }
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    std::unique_ptr<FrameSource> source;
+    if (!replay_path.empty()) {
+        source.reset(new ReplaySource(replay_path, max_speed ? ReplaySource::MAX_SPEED : ReplaySource::RECORDED_SPEED));
+    } else if (!filename.empty()) {
+        source.reset(new CaptureSource(filename));
+    } else {
+        source.reset(new CaptureSource(device));
+    }
+    cv::Mat frame;
+    if (!source->isOpened() || !source->read(frame)) {
+        std::cerr << "Unable to capture the first frame" << std::endl;
+        return 1;
+    }
+
+    // Геометрия кольца задаётся первым кадром
+    SharedFrameRing ring;
+    if (!ring.create(name, slots, frame.size(), frame.type())) {
+        return 1;
+    }
+    std::cout << "Publishing " << frame.cols << "x" << frame.rows << " frames to " << name << std::endl;
+
+    size_t published = 0;
+    do {
+        if (ring.write(frame, source->timestamp())) {
+            published++;
+        }
+    } while (!stop_requested && source->read(frame));
+
+    // Закрытие кольца сообщает потребителям, что кадров больше не будет
+    ring.close();
+    std::cout << "Published " << published << " frames" << std::endl;
+    return 0;
+}
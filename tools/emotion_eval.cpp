@@ -0,0 +1,303 @@
+/**
+ * @file emotion_eval.cpp
+ * @brief Оценка точности и скорости модели на наборе данных вида <split>/<класс>/<файл>.jpg.
+ * Изображения декодируются и предобрабатываются параллельно пачками, каждая пачка
+ * классифицируется одним прямым проходом InferenceEngine.
+ */
+
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Image.h"
+#include "InferenceEngine.h"
+#include "LatencyStats.h"
+#include "Model.h"
+#include "ModelBundle.h"
+#include "ThreadPool.h"
+
+/**
+ * @struct EvalOptions
+ * @brief Параметры командной строки.
+ */
+struct EvalOptions {
+    std::string dataset; ///< Корень набора данных или каталог одной части.
+    std::string split = "validation"; ///< Часть набора данных (train или validation).
+    std::string bundle_path = ModelBundle::DEFAULT_PATH; ///< Путь к пакету моделей.
+    bool bundle_required = false; ///< Пакет моделей задан явно (--bundle): без него запуск прерывается.
+    bool bundle_verify = false; ///< Проверять контрольные суммы содержимого пакета (--verify-bundle).
+    std::string model_path = ModelBundle::DEFAULT_MODEL_PATH; ///< Путь к модели, если пакета нет.
+    size_t threads = 0; ///< Количество потоков (0 - по числу ядер).
+    size_t batch = 32; ///< Размер пачки.
+    size_t limit = 0; ///< Наибольшее число изображений каждого класса (0 - все).
+};
+
+/**
+ * @struct Sample
+ * @brief Изображение набора данных и его класс.
+ */
+struct Sample {
+    std::string path; ///< Путь к изображению.
+    int class_id; ///< Истинный класс.
+};
+
+/**
+ * @struct BatchResult
+ * @brief Результат обработки одной пачки.
+ */
+struct BatchResult {
+    std::vector<std::pair<int, int>> outcomes; ///< Пары (истинный класс, предсказанный класс).
+    size_t unreadable = 0; ///< Количество изображений, которые не удалось прочитать.
+    double preprocess_ms = 0.0; ///< Время декодирования и предобработки пачки.
+    double inference_ms = 0.0; ///< Время прямого прохода, в который вошла пачка.
+    double queue_ms = 0.0; ///< Время ожидания, пока сеть выполняла проходы других потоков.
+};
+
+/**
+ * @brief Собирает список изображений: каталоги классов сопоставляются с классами модели по названию.
+ * @param root Каталог части набора данных.
+ * @param limit Наибольшее число изображений каждого класса (0 - все).
+ * @return Список изображений.
+ */
+static std::vector<Sample> listSamples(const std::filesystem::path& root, size_t limit) {
+    std::vector<Sample> samples;
+    for (const auto& class_dir : std::filesystem::directory_iterator(root)) {
+        if (!class_dir.is_directory()) {
+            continue;
+        }
+
+        std::string class_name = class_dir.path().filename().string();
+        int class_id = Model::classId(class_name);
+        if (class_id < 0) {
+            std::cerr << "Skipping unknown class directory " << class_name << std::endl;
+            continue;
+        }
+
+        std::vector<std::string> paths;
+        for (const auto& file : std::filesystem::directory_iterator(class_dir.path())) {
+            if (file.is_regular_file()) {
+                paths.push_back(file.path().string());
+            }
+        }
+        // Порядок обхода каталога не определён; сортировка делает --limit воспроизводимым
+        std::sort(paths.begin(), paths.end());
+        if (limit > 0 && paths.size() > limit) {
+            paths.resize(limit);
+        }
+        for (const std::string& path : paths) {
+            samples.push_back({path, class_id});
+        }
+    }
+    return samples;
+}
+
+/**
+ * @brief Декодирует, предобрабатывает и классифицирует одну пачку.
+ * @param engine Движок предсказаний.
+ * @param samples Все изображения.
+ * @param begin Индекс первого изображения пачки.
+ * @param end Индекс за последним изображением пачки.
+ * @return Результат пачки.
+ */
+static BatchResult evaluateBatch(InferenceEngine& engine, const std::vector<Sample>& samples, size_t begin, size_t end) {
+    BatchResult result;
+    auto started = std::chrono::steady_clock::now();
+
+    // Изображения набора данных - уже вырезанные лица, поэтому целый кадр и есть ROI
+    Image image_and_ROI;
+    std::vector<int> labels;
+    for (size_t i = begin; i < end; i++) {
+        cv::Mat face = cv::imread(samples[i].path, cv::IMREAD_GRAYSCALE);
+        if (face.empty()) {
+            result.unreadable++;
+            continue;
+        }
+        image_and_ROI.setROI(face);
+        labels.push_back(samples[i].class_id);
+    }
+    image_and_ROI.preprocessROI();
+    auto preprocessed = std::chrono::steady_clock::now();
+
+    // Вызов predict ждёт, пока сеть занята другими потоками; время прохода движок сообщает отдельно
+    double forward_ms = 0.0;
+    std::vector<EmotionPrediction> predictions = engine.predict(image_and_ROI.getModelInput(), forward_ms);
+    auto finished = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < predictions.size() && i < labels.size(); i++) {
+        result.outcomes.push_back({labels[i], predictions[i].class_id});
+    }
+    result.preprocess_ms = std::chrono::duration<double, std::milli>(preprocessed - started).count();
+    result.inference_ms = forward_ms;
+    result.queue_ms = std::max(0.0, std::chrono::duration<double, std::milli>(finished - preprocessed).count() - forward_ms);
+    return result;
+}
+
+/**
+ * @brief Выводит матрицу ошибок и точность по классам.
+ * @param confusion Матрица ошибок: строки - истинные классы, столбцы - предсказанные.
+ */
+static void printConfusion(const std::vector<std::vector<size_t>>& confusion) {
+    const int classes = Model::classCount();
+
+    std::printf("\nConfusion matrix (rows: actual, columns: predicted)\n%-10s", "");
+    for (int j = 0; j < classes; j++) {
+        std::printf("%9.8s", Model::className(j).c_str());
+    }
+    std::printf("\n");
+    for (int i = 0; i < classes; i++) {
+        std::printf("%-10s", Model::className(i).c_str());
+        for (int j = 0; j < classes; j++) {
+            std::printf("%9zu", confusion[i][j]);
+        }
+        std::printf("\n");
+    }
+
+    size_t correct = 0;
+    size_t total = 0;
+    std::printf("\nPer-class accuracy\n");
+    for (int i = 0; i < classes; i++) {
+        size_t row = 0;
+        for (int j = 0; j < classes; j++) {
+            row += confusion[i][j];
+        }
+        correct += confusion[i][i];
+        total += row;
+        if (row > 0) {
+            std::printf("%-10s %6.2f%% (%zu/%zu)\n", Model::className(i).c_str(), 100.0 * confusion[i][i] / row,
+                        confusion[i][i], row);
+        } else {
+            std::printf("%-10s %7s (0 images)\n", Model::className(i).c_str(), "-");
+        }
+    }
+    if (total > 0) {
+        std::printf("%-10s %6.2f%% (%zu/%zu)\n", "Overall", 100.0 * correct / total, correct, total);
+    }
+}
+
+/**
+ * @brief Главная функция утилиты оценки.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы: каталог набора данных, --split NAME, --threads N, --batch N, --limit N,
+ * --bundle PATH, --verify-bundle, --model PATH.
+ * @return Код завершения программы.
+ */
+int main(int argc, char** argv) {
+    EvalOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--split" && i + 1 < argc) {
+            options.split = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::stoul(argv[++i]);
+        } else if (arg == "--batch" && i + 1 < argc) {
+            options.batch = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--limit" && i + 1 < argc) {
+            options.limit = std::stoul(argv[++i]);
+        } else if (arg == "--bundle" && i + 1 < argc) {
+            options.bundle_path = argv[++i];
+            options.bundle_required = true;
+        } else if (arg == "--verify-bundle") {
+            options.bundle_verify = true;
+        } else if (arg == "--model" && i + 1 < argc) {
+            options.model_path = argv[++i];
+            options.bundle_path.clear();
+            options.bundle_required = false;
+        } else if (options.dataset.empty() && arg[0] != '-') {
+            options.dataset = arg;
+        } else {
+            options.dataset.clear();
+            break;
+        }
+    }
+    if (options.dataset.empty()) {
+        std::cerr << "usage: " << argv[0] << " <dataset> [--split validation] [--threads N] [--batch N]"
+                  << " [--limit N] [--bundle PATH [--verify-bundle] | --model PATH]" << std::endl;
+        return 1;
+    }
+
+    // Можно указать как корень с train/ и validation/, так и сам каталог части
+    std::filesystem::path root = std::filesystem::path(options.dataset) / options.split;
+    if (!std::filesystem::is_directory(root)) {
+        root = options.dataset;
+    }
+    if (!std::filesystem::is_directory(root)) {
+        std::cerr << "Dataset directory " << root << " does not exist" << std::endl;
+        return 1;
+    }
+
+    std::vector<Sample> samples = listSamples(root, options.limit);
+    if (samples.empty()) {
+        std::cerr << "No images found in " << root << std::endl;
+        return 1;
+    }
+
+    ThreadPool pool(options.threads);
+    ModelBundle bundle;
+    if (!bundle.openForCli(options.bundle_path, options.bundle_required, options.bundle_verify)) {
+        return 1;
+    }
+    // Потоки пула готовят пачки параллельно; пачки, готовые одновременно, выполняются одним прямым проходом
+    std::unique_ptr<InferenceEngine> engine(bundle.isOpen()
+        ? new InferenceEngine(bundle)
+        : new InferenceEngine(options.model_path));
+    if (engine->empty()) {
+        return 1;
+    }
+
+    std::cout << "Evaluating " << samples.size() << " images from " << root << " with " << pool.size()
+              << " threads, batch " << options.batch << std::endl;
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::future<BatchResult>> batches;
+    for (size_t begin = 0; begin < samples.size(); begin += options.batch) {
+        size_t end = std::min(samples.size(), begin + options.batch);
+        InferenceEngine* shared_engine = engine.get();
+        batches.push_back(pool.submit([shared_engine, &samples, begin, end]() {
+            return evaluateBatch(*shared_engine, samples, begin, end);
+        }));
+    }
+
+    std::vector<std::vector<size_t>> confusion(Model::classCount(), std::vector<size_t>(Model::classCount(), 0));
+    LatencyStats batch_latency;
+    LatencyStats inference_latency;
+    LatencyStats queue_latency;
+    size_t evaluated = 0;
+    size_t unreadable = 0;
+    for (std::future<BatchResult>& future : batches) {
+        BatchResult result = future.get();
+        for (const std::pair<int, int>& outcome : result.outcomes) {
+            if (outcome.second >= 0 && outcome.second < Model::classCount()) {
+                confusion[outcome.first][outcome.second]++;
+            }
+        }
+        evaluated += result.outcomes.size();
+        unreadable += result.unreadable;
+        batch_latency.record(result.preprocess_ms + result.queue_ms + result.inference_ms);
+        inference_latency.record(result.inference_ms);
+        queue_latency.record(result.queue_ms);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    printConfusion(confusion);
+
+    std::printf("\nThroughput: %.1f images/sec (%zu images in %.2f s", evaluated / elapsed, evaluated, elapsed);
+    if (unreadable > 0) {
+        std::printf(", %zu unreadable", unreadable);
+    }
+    std::printf(")\n");
+    std::printf("Batch latency (decode + preprocess + queue + forward): p50 %.2f ms, p99 %.2f ms\n",
+                batch_latency.percentile(50), batch_latency.percentile(99));
+    std::printf("Forward latency per batch: p50 %.2f ms, p99 %.2f ms\n",
+                inference_latency.percentile(50), inference_latency.percentile(99));
+    std::printf("Queue wait per batch: p50 %.2f ms, p99 %.2f ms\n",
+                queue_latency.percentile(50), queue_latency.percentile(99));
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file emotion_loadgen.cpp
+ * @brief Генератор нагрузки для локального сервера предсказаний.
+ * Несколько клиентов параллельно отправляют один и тот же кадр (или лицо 48x48)
+ * и измеряют задержку каждого запроса.
+ */
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Image.h"
+#include "InferenceProtocol.h"
+#include "LatencyStats.h"
+
+/**
+ * @brief Названия классов в порядке ID, как в Model.
+ */
+static const char* const CLASS_NAMES[PROTOCOL_CLASS_COUNT] = {"Angry", "Disgust", "Fear", "Happy",
+                                                              "Sad", "Surprise", "Neutral"};
+
+/**
+ * @struct LoadOptions
+ * @brief Параметры командной строки генератора нагрузки.
+ */
+struct LoadOptions {
+    std::string image_path; ///< Кадр, который отправляется в каждом запросе.
+    std::string socket_path = "/tmp/emotion_server.sock"; ///< Путь к сокету сервера.
+    size_t clients = 4; ///< Количество параллельных подключений.
+    size_t requests = 200; ///< Количество запросов на подключение.
+    bool faces = false; ///< Отправлять кадр, уменьшенный до лица 48x48, вместо закодированного файла.
+};
+
+/**
+ * @brief Готовит данные запроса.
+ * @param options Параметры генератора.
+ * @param kind Вид запроса.
+ * @param payload Данные запроса.
+ * @return true, если данные готовы.
+ */
+static bool loadPayload(const LoadOptions& options, RequestKind& kind, std::vector<uchar>& payload) {
+    if (!options.faces) {
+        // Файл отправляется как есть, сервер сам декодирует его и ищет лица
+        std::ifstream file(options.image_path, std::ios::binary);
+        payload.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        kind = REQUEST_ENCODED_FRAME;
+        return !payload.empty();
+    }
+
+    cv::Mat frame = cv::imread(options.image_path);
+    if (frame.empty()) {
+        return false;
+    }
+    cv::Mat gray;
+    cv::Mat face;
+    Image::toGray(frame, gray);
+    cv::resize(gray, face, cv::Size(PROTOCOL_FACE_SIZE, PROTOCOL_FACE_SIZE));
+    payload.assign(face.data, face.data + face.total());
+    kind = REQUEST_FACES;
+    return true;
+}
+
+/**
+ * @brief Главная функция генератора нагрузки.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы: путь к изображению, --socket PATH, --clients N, --requests N, --faces.
+ * @return Код завершения программы.
+ */
+int main(int argc, char** argv) {
+    LoadOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            options.socket_path = argv[++i];
+        } else if (arg == "--clients" && i + 1 < argc) {
+            options.clients = std::stoul(argv[++i]);
+        } else if (arg == "--requests" && i + 1 < argc) {
+            options.requests = std::stoul(argv[++i]);
+        } else if (arg == "--faces") {
+            options.faces = true;
+        } else if (options.image_path.empty() && arg[0] != '-') {
+            options.image_path = arg;
+        } else {
+            options.image_path.clear();
+            break;
+        }
+    }
+    if (options.image_path.empty()) {
+        std::cerr << "usage: " << argv[0] << " <image> [--socket PATH] [--clients N] [--requests N] [--faces]"
+                  << std::endl;
+        return 1;
+    }
+
+    RequestKind kind;
+    std::vector<uchar> payload;
+    if (!loadPayload(options, kind, payload)) {
+        std::cerr << "Unable to read " << options.image_path << std::endl;
+        return 1;
+    }
+
+    LatencyStats latency;
+    std::atomic<size_t> failures{0};
+    std::vector<FaceResult> sample;
+    std::atomic<bool> sample_taken{false};
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < options.clients; c++) {
+        clients.emplace_back([&, c]() {
+            LocalSocket socket = LocalSocket::connect(options.socket_path);
+            if (!socket.isOpen()) {
+                failures += options.requests;
+                return;
+            }
+
+            std::vector<FaceResult> faces;
+            for (size_t i = 0; i < options.requests; i++) {
+                RequestHeader header = {REQUEST_MAGIC, kind, static_cast<uint32_t>(c * options.requests + i),
+                                        static_cast<uint32_t>(payload.size())};
+                auto sent_at = std::chrono::steady_clock::now();
+
+                ResponseHeader response;
+                bool ok = socket.writeRequest(header, payload.data()) && socket.readResponse(response, faces) &&
+                          response.request_id == header.request_id;
+                if (!ok) {
+                    failures += options.requests - i;
+                    return;
+                }
+
+                latency.record(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sent_at).count());
+                if (response.status != RESPONSE_OK) {
+                    failures++;
+                } else if (!sample_taken.exchange(true)) {
+                    sample = faces;
+                }
+            }
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    for (const FaceResult& face : sample) {
+        std::string name = face.class_id >= 0 && face.class_id < PROTOCOL_CLASS_COUNT ? CLASS_NAMES[face.class_id] : "?";
+        std::cout << "face " << face.x << "," << face.y << " " << face.width << "x" << face.height
+                  << ": " << name << " " << face.probability * 100 << "%" << std::endl;
+    }
+    std::cout << "requests: " << latency.count() << " completed, " << failures << " failed, "
+              << latency.count() / elapsed << " req/s" << std::endl
+              << "latency:  " << latency.summary() << std::endl;
+    return failures > 0 ? 1 : 0;
+}
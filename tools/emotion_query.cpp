@@ -0,0 +1,170 @@
+/**
+ * @file emotion_query.cpp
+ * @brief Запросы к хранилищу результатов (ResultStore) по интервалу времени:
+ * распределение эмоций и моменты, в которых вероятность эмоции выше порога.
+ * Хранилище отображается в память, поэтому запрос читает только блоки нужного интервала.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Model.h"
+#include "ResultStore.h"
+
+/**
+ * @struct QueryOptions
+ * @brief Параметры командной строки.
+ */
+struct QueryOptions {
+    std::string store_path; ///< Путь к хранилищу результатов.
+    double from = -std::numeric_limits<double>::infinity(); ///< Начало интервала, с.
+    double to = std::numeric_limits<double>::infinity(); ///< Конец интервала, с.
+    std::string above_class; ///< Эмоция для поиска по порогу (пусто - распределение).
+    float threshold = 0.5f; ///< Порог вероятности.
+    size_t limit = 50; ///< Наибольшее количество выводимых записей.
+};
+
+/**
+ * @brief Разбирает время вида HH:MM:SS[.fff], MM:SS[.fff] или секунды.
+ * @param text Строка времени.
+ * @param seconds Время, с.
+ * @return true, если строка корректна.
+ */
+static bool parseTime(const std::string& text, double& seconds) {
+    std::istringstream input(text);
+    seconds = 0.0;
+    double part = 0.0;
+    int parts = 0;
+    while (input >> part) {
+        seconds = seconds * 60.0 + part;
+        parts++;
+        if (input.peek() != ':') {
+            break;
+        }
+        input.get();
+    }
+    return parts > 0 && parts <= 3 && input.eof();
+}
+
+/**
+ * @brief Форматирует время как HH:MM:SS.fff.
+ * @param seconds Время, с.
+ * @return Строка времени.
+ */
+static std::string formatTime(double seconds) {
+    long long millis = static_cast<long long>(seconds * 1000.0 + 0.5);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%02lld:%02lld:%02lld.%03lld", millis / 3600000, millis / 60000 % 60,
+                  millis / 1000 % 60, millis % 1000);
+    return buffer;
+}
+
+/**
+ * @brief Выводит распределение эмоций в интервале.
+ * @param store Хранилище результатов.
+ * @param options Параметры запроса.
+ */
+static void printDistribution(const ResultStore& store, const QueryOptions& options) {
+    std::vector<uint64_t> counts = store.distribution(options.from, options.to);
+    uint64_t total = 0;
+    for (uint64_t count : counts) {
+        total += count;
+    }
+
+    std::cout << total << " face results in the interval" << std::endl;
+    for (size_t i = 0; i < counts.size(); i++) {
+        double share = total > 0 ? 100.0 * counts[i] / total : 0.0;
+        std::cout << std::setw(10) << Model::className(static_cast<int>(i)) << " : " << std::setw(8) << counts[i]
+                  << "  " << std::fixed << std::setprecision(1) << share << "%" << std::endl;
+    }
+}
+
+/**
+ * @brief Выводит записи интервала, в которых вероятность эмоции выше порога.
+ * @param store Хранилище результатов.
+ * @param class_id ID эмоции.
+ * @param options Параметры запроса.
+ */
+static void printMatches(const ResultStore& store, int class_id, const QueryOptions& options) {
+    std::vector<uint64_t> matches = store.findAbove(class_id, options.threshold, options.from, options.to);
+    std::cout << matches.size() << " face results with " << Model::className(class_id) << " above "
+              << options.threshold << std::endl;
+
+    for (size_t i = 0; i < matches.size() && i < options.limit; i++) {
+        uint64_t index = matches[i];
+        cv::Rect face = store.face(index);
+        std::cout << formatTime(store.timestamp(index)) << "  frame " << store.frameNumber(index) << "  face "
+                  << face.x << "," << face.y << " " << face.width << "x" << face.height << "  "
+                  << std::fixed << std::setprecision(3) << store.score(index, class_id) << std::endl;
+    }
+    if (matches.size() > options.limit) {
+        std::cout << "... " << matches.size() - options.limit << " more (--limit)" << std::endl;
+    }
+}
+
+/**
+ * @brief Главная функция утилиты запросов.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы: путь к хранилищу, --from T, --to T, --above EMOTION P, --limit N.
+ * Время задаётся как HH:MM:SS[.fff], MM:SS или в секундах.
+ * @return 0 при успехе, 1 при ошибке.
+ */
+int main(int argc, char** argv) {
+    QueryOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "--from" || arg == "--to") && i + 1 < argc) {
+            if (!parseTime(argv[++i], arg == "--from" ? options.from : options.to)) {
+                std::cerr << "Invalid time " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--above" && i + 2 < argc) {
+            options.above_class = argv[++i];
+            options.threshold = std::stof(argv[++i]);
+        } else if (arg == "--limit" && i + 1 < argc) {
+            options.limit = std::stoul(argv[++i]);
+        } else if (options.store_path.empty()) {
+            options.store_path = arg;
+        }
+    }
+    if (options.store_path.empty()) {
+        std::cerr << "usage: " << argv[0] << " <store> [--from T] [--to T] [--above EMOTION P] [--limit N]" << std::endl;
+        return 1;
+    }
+
+    ResultStore store;
+    if (!store.open(options.store_path)) {
+        return 1;
+    }
+    if (store.classCount() != static_cast<size_t>(Model::classCount())) {
+        std::cerr << "Result store has " << store.classCount() << " classes, the model has "
+                  << Model::classCount() << std::endl;
+        return 1;
+    }
+    std::cout << store.size() << " face results";
+    if (store.size() > 0) {
+        std::cout << " from " << formatTime(store.timestamp(0)) << " to " << formatTime(store.timestamp(store.size() - 1));
+    }
+    std::cout << std::endl;
+
+    auto started = std::chrono::steady_clock::now();
+    if (options.above_class.empty()) {
+        printDistribution(store, options);
+    } else {
+        int class_id = Model::classId(options.above_class);
+        if (class_id < 0) {
+            std::cerr << "Unknown emotion " << options.above_class << std::endl;
+            return 1;
+        }
+        printMatches(store, class_id, options);
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "Query took " << std::fixed << std::setprecision(2) << elapsed << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,385 @@
+/**
+ * @file emotion_server.cpp
+ * @brief Локальный сервер предсказаний эмоций на сокете домена Unix.
+ * Модель загружается один раз, а запросы от всех клиентов объединяются в пачки.
+ */
+
+#include <unistd.h>
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FaceDetector.h"
+#include "Image.h"
+#include "InferenceBatcher.h"
+#include "InferenceEngine.h"
+#include "InferenceProtocol.h"
+#include "LatencyStats.h"
+#include "ModelBundle.h"
+
+/**
+ * @brief Путь к сокету по умолчанию.
+ */
+const std::string DEFAULT_SOCKET_PATH = "/tmp/emotion_server.sock";
+
+/**
+ * @brief Признак остановки сервера (SIGINT, SIGTERM).
+ */
+static std::atomic<bool> stop_requested{false};
+
+/**
+ * @brief Обработчик сигналов остановки.
+ */
+static void requestStop(int) {
+    stop_requested = true;
+}
+
+/**
+ * @struct ServerOptions
+ * @brief Параметры командной строки сервера.
+ */
+struct ServerOptions {
+    std::string socket_path = DEFAULT_SOCKET_PATH; ///< Путь к сокету.
+    std::string bundle_path = ModelBundle::DEFAULT_PATH; ///< Путь к пакету моделей.
+    bool bundle_required = false; ///< Пакет моделей задан явно (--bundle): без него запуск прерывается.
+    bool bundle_verify = false; ///< Проверять контрольные суммы содержимого пакета (--verify-bundle).
+    InferenceBatcher::Settings batching; ///< Параметры объединения в пачки.
+    size_t detectors = std::max(1u, std::thread::hardware_concurrency()); ///< Количество детекторов лиц.
+    double report_interval = 10.0; ///< Период вывода статистики, с.
+};
+
+/**
+ * @class DetectorPool
+ * @brief Детекторы лиц, созданные при запуске сервера. Детектор не потокобезопасен, а его создание
+ * разбирает каскад, поэтому запрос с кадром берёт свободный детектор на время поиска лиц
+ * и ждёт, если все детекторы заняты.
+ */
+class DetectorPool {
+
+public:
+    /**
+     * @class Lease
+     * @brief Детектор, взятый из пула; возвращается в пул деструктором.
+     */
+    class Lease {
+
+    public:
+        /**
+         * @brief Конструктор принимает детектор, взятый из пула.
+         * @param pool Пул, которому принадлежит детектор.
+         * @param detector Детектор.
+         */
+        Lease(DetectorPool& pool, std::unique_ptr<FaceDetector> detector)
+            : pool(pool), detector(std::move(detector)) {}
+
+        /**
+         * @brief Деструктор возвращает детектор в пул.
+         */
+        ~Lease() {
+            pool.release(std::move(detector));
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        /**
+         * @brief Доступ к детектору.
+         * @return Детектор.
+         */
+        FaceDetector* operator->() const {
+            return detector.get();
+        }
+
+    private:
+        DetectorPool& pool; ///< Пул, которому принадлежит детектор.
+        std::unique_ptr<FaceDetector> detector; ///< Взятый детектор.
+    };
+
+    /**
+     * @brief Конструктор создаёт все детекторы пула.
+     * @param bundle Пакет моделей (может быть закрыт).
+     * @param count Количество детекторов.
+     */
+    DetectorPool(const ModelBundle& bundle, size_t count) {
+        for (size_t i = 0; i < std::max<size_t>(1, count); i++) {
+            idle.emplace_back(bundle.isOpen() ? new FaceDetector(bundle)
+                                              : new FaceDetector(ModelBundle::DEFAULT_CASCADE_PATH));
+        }
+    }
+
+    /**
+     * @brief Берёт свободный детектор, ожидая его освобождения.
+     * @return Детектор, возвращаемый в пул при уничтожении.
+     */
+    Lease acquire() {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [this]() { return !idle.empty(); });
+        std::unique_ptr<FaceDetector> detector = std::move(idle.back());
+        idle.pop_back();
+        return Lease(*this, std::move(detector));
+    }
+
+private:
+    /**
+     * @brief Возвращает детектор в пул.
+     * @param detector Детектор.
+     */
+    void release(std::unique_ptr<FaceDetector> detector) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(std::move(detector));
+        }
+        released.notify_one();
+    }
+
+    std::vector<std::unique_ptr<FaceDetector>> idle; ///< Свободные детекторы.
+    std::mutex mutex; ///< Защита списка свободных детекторов.
+    std::condition_variable released; ///< Сигнал о возврате детектора.
+};
+
+/**
+ * @struct Server
+ * @brief Общее состояние сервера, разделяемое обработчиками подключений.
+ */
+struct Server {
+    DetectorPool& detectors; ///< Детекторы лиц для запросов с кадрами.
+    InferenceBatcher& batcher; ///< Очередь пачек.
+    LatencyStats request_stats{}; ///< Время обработки запроса на сервере.
+};
+
+/**
+ * @brief Формирует результат для одного лица.
+ * @param prediction Предсказание модели.
+ * @param face Рамка лица в кадре.
+ * @return Запись ответа.
+ */
+static FaceResult makeFaceResult(const EmotionPrediction& prediction, const cv::Rect& face) {
+    FaceResult result = {};
+    result.x = face.x;
+    result.y = face.y;
+    result.width = face.width;
+    result.height = face.height;
+    result.class_id = prediction.class_id;
+    result.probability = prediction.probability;
+    for (size_t i = 0; i < prediction.scores.size() && i < PROTOCOL_CLASS_COUNT; i++) {
+        result.scores[i] = prediction.scores[i];
+    }
+    return result;
+}
+
+/**
+ * @brief Выполняет один запрос.
+ * @param server Состояние сервера.
+ * @param header Заголовок запроса.
+ * @param payload Данные запроса.
+ * @param faces Результаты для лиц.
+ * @return Код результата.
+ */
+static ResponseStatus handleRequest(Server& server, const RequestHeader& header, std::vector<uchar>& payload,
+                                    std::vector<FaceResult>& faces) {
+    std::vector<cv::Mat> inputs;
+    std::vector<cv::Rect> boxes;
+
+    if (header.kind == REQUEST_FACES) {
+        const size_t face_bytes = PROTOCOL_FACE_SIZE * PROTOCOL_FACE_SIZE;
+        if (payload.empty() || payload.size() % face_bytes != 0) {
+            return RESPONSE_BAD_REQUEST;
+        }
+
+        // Вырезанные лица приводятся к входу модели так же, как в Image::preprocessROI
+        for (size_t offset = 0; offset < payload.size(); offset += face_bytes) {
+            cv::Mat face(PROTOCOL_FACE_SIZE, PROTOCOL_FACE_SIZE, CV_8UC1, payload.data() + offset);
+            cv::Mat input;
+            face.convertTo(input, CV_32F, 1.0 / 255);
+            inputs.push_back(input);
+            boxes.push_back(cv::Rect());
+        }
+    } else if (header.kind == REQUEST_ENCODED_FRAME) {
+        cv::Mat frame = cv::imdecode(payload, cv::IMREAD_COLOR);
+        if (frame.empty()) {
+            return RESPONSE_DECODE_FAILED;
+        }
+
+        // Детектор занят только на время поиска лиц и возвращается в пул до предсказания
+        DetectorPool::Lease face_detector = server.detectors.acquire();
+        boxes = face_detector->detectFace(frame);
+        if (!boxes.empty()) {
+            Image image_and_ROI = face_detector->extractROI(frame);
+            image_and_ROI.preprocessROI();
+            inputs = image_and_ROI.getModelInput();
+        }
+    } else {
+        return RESPONSE_BAD_REQUEST;
+    }
+
+    try {
+        std::vector<EmotionPrediction> predictions = server.batcher.predict(inputs);
+        for (size_t i = 0; i < predictions.size() && i < boxes.size(); i++) {
+            faces.push_back(makeFaceResult(predictions[i], boxes[i]));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Inference failed: " << e.what() << std::endl;
+        return RESPONSE_INFERENCE_FAILED;
+    }
+    return RESPONSE_OK;
+}
+
+/**
+ * @brief Обслуживает одно подключение до его закрытия.
+ * @param server Состояние сервера.
+ * @param socket Подключённый сокет.
+ */
+static void serveConnection(Server& server, LocalSocket& socket) {
+    std::vector<uchar> payload;
+    std::vector<FaceResult> faces;
+
+    // Соединение закрывается при ошибке чтения или неверном заголовке запроса
+    RequestHeader header;
+    while (socket.readRequest(header, payload)) {
+        auto started = std::chrono::steady_clock::now();
+        faces.clear();
+        ResponseStatus status = handleRequest(server, header, payload, faces);
+
+        bool sent = socket.writeResponse({RESPONSE_MAGIC, status, header.request_id, 0}, faces);
+        server.request_stats.record(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count());
+        if (!sent) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Выводит статистику задержек и пачек.
+ * @param server Состояние сервера.
+ */
+static void printStats(const Server& server) {
+    std::cout << "requests: " << server.request_stats.summary() << std::endl
+              << "queue:    " << server.batcher.queueStats().summary() << std::endl
+              << "batches:  " << server.batcher.batchCount()
+              << " mean size " << server.batcher.meanBatchSize() << std::endl;
+}
+
+/**
+ * @struct Connection
+ * @brief Подключение и обслуживающий его поток.
+ */
+struct Connection {
+    LocalSocket socket; ///< Сокет клиента.
+    std::atomic<bool> finished{false}; ///< Признак завершения потока.
+    std::thread thread; ///< Поток обслуживания.
+};
+
+/**
+ * @brief Главная функция сервера.
+ * @param argc Количество аргументов командной строки.
+ * @param argv Аргументы: --socket PATH, --bundle PATH, --verify-bundle, --detectors N, --max-batch N,
+ * --max-delay-ms MS, --report-interval S.
+ * @return Код завершения программы.
+ */
+int main(int argc, char** argv) {
+    ServerOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            options.socket_path = argv[++i];
+        } else if (arg == "--bundle" && i + 1 < argc) {
+            options.bundle_path = argv[++i];
+            options.bundle_required = true;
+        } else if (arg == "--verify-bundle") {
+            options.bundle_verify = true;
+        } else if (arg == "--detectors" && i + 1 < argc) {
+            options.detectors = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--max-batch" && i + 1 < argc) {
+            options.batching.max_batch = std::stoul(argv[++i]);
+        } else if (arg == "--max-delay-ms" && i + 1 < argc) {
+            options.batching.max_delay_ms = std::stod(argv[++i]);
+        } else if (arg == "--report-interval" && i + 1 < argc) {
+            options.report_interval = std::stod(argv[++i]);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--socket PATH] [--bundle PATH] [--verify-bundle]"
+                      << " [--detectors N] [--max-batch N] [--max-delay-ms MS] [--report-interval S]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // Модели загружаются один раз на всё время работы сервера
+    ModelBundle bundle;
+    if (!bundle.openForCli(options.bundle_path, options.bundle_required, options.bundle_verify)) {
+        return 1;
+    }
+    std::unique_ptr<InferenceEngine> engine(bundle.isOpen()
+        ? new InferenceEngine(bundle)
+        : new InferenceEngine(ModelBundle::DEFAULT_MODEL_PATH));
+    if (engine->empty()) {
+        return 1;
+    }
+
+    // Каскад разбирается при запуске для каждого детектора, а не при подключении клиента
+    DetectorPool detectors(bundle, options.detectors);
+    InferenceBatcher batcher(*engine, options.batching);
+    Server server{detectors, batcher};
+
+    LocalSocket listener = LocalSocket::listen(options.socket_path);
+    if (!listener.isOpen()) {
+        return 1;
+    }
+    std::cout << "Listening on " << options.socket_path << std::endl;
+
+    std::vector<std::unique_ptr<Connection>> connections;
+    auto last_report = std::chrono::steady_clock::now();
+    while (!stop_requested) {
+        LocalSocket client = listener.accept(200);
+        if (client.isOpen()) {
+            std::unique_ptr<Connection> connection(new Connection());
+            connection->socket = std::move(client);
+            Connection* raw = connection.get();
+            connection->thread = std::thread([&server, raw]() {
+                serveConnection(server, raw->socket);
+                raw->finished = true;
+            });
+            connections.push_back(std::move(connection));
+        }
+
+        // Потоки закрытых подключений освобождаются сразу
+        for (auto it = connections.begin(); it != connections.end();) {
+            if ((*it)->finished) {
+                (*it)->thread.join();
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (options.report_interval > 0 &&
+            std::chrono::duration<double>(now - last_report).count() >= options.report_interval) {
+            printStats(server);
+            last_report = now;
+        }
+    }
+
+    // Остановка: прерывание чтения во всех подключениях и ожидание их потоков
+    for (std::unique_ptr<Connection>& connection : connections) {
+        connection->socket.shutdown();
+        connection->thread.join();
+    }
+    listener.close();
+    ::unlink(options.socket_path.c_str());
+
+    printStats(server);
+    return 0;
+}